@@ -0,0 +1,314 @@
+#include "analysiscache.h"
+#include "analysisexecutor.h"
+#include "analysisjob.h"
+#include "mediafingerprint.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+
+static const quint32 AnalysisMagic = 0x43415651; // "QVAC"
+static const quint16 AnalysisVersion = 1;
+static const int HeaderSize = 4 + 2 + 2 + 4;
+static const int SecondSize = 3 + AnalysisCache::HistogramBins;
+
+AnalysisCache::AnalysisCache(QObject *parent)
+    : QObject(parent)
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(5000);
+    connect(&m_saveTimer, &QTimer::timeout, this, [this]() {
+        if (m_dirty && save())
+            m_dirty = false;
+    });
+}
+
+AnalysisCache::~AnalysisCache()
+{
+    AnalysisExecutor::instance()->cancel(this);
+    stopScan();
+    flush();
+}
+
+void AnalysisCache::setMedia(const QUrl &url, qint64 duration)
+{
+    int count = duration > 0 ? int((duration + 999) / 1000) : 0;
+    if (url == m_url && count == m_seconds.size())
+        return;
+
+    stopScan();
+    flush();
+
+    m_url = url;
+    m_seconds.clear();
+    m_fileName.clear();
+    m_video = PendingVideo();
+    m_audio = PendingAudio();
+    m_scanVideo = PendingVideo();
+    m_scanAudio = PendingAudio();
+    ++m_generation;
+
+    if (url.isEmpty() || !count) {
+        emit loaded(false);
+        return;
+    }
+
+    // Fingerprinting and loading read the file, so they run on the executor;
+    // live results collect in the meantime.
+    m_seconds = QVector<Second>(count);
+    const int generation = m_generation;
+    AnalysisExecutor::instance()->submit(this, [this, generation, url, count]() {
+        const QString fileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                + "/analysis/" + mediaFingerprint(url) + ".qvac";
+        QVector<Second> seconds;
+        if (!load(fileName, &seconds) || seconds.size() != count)
+            seconds.clear();
+        QMetaObject::invokeMethod(this, [this, generation, fileName, seconds]() {
+            mediaLoaded(generation, fileName, seconds);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AnalysisCache::mediaLoaded(int generation, const QString &fileName, const QVector<Second> &seconds)
+{
+    if (generation != m_generation)
+        return;
+
+    m_fileName = fileName;
+    if (seconds.size() == m_seconds.size()) {
+        for (int i = 0; i < seconds.size(); ++i) {
+            if (!m_seconds.at(i).flags)
+                m_seconds[i] = seconds.at(i);
+        }
+    }
+
+    emit loaded(isComplete());
+
+    if (m_scanRate > 0 && m_url.isLocalFile() && !isComplete())
+        startScan();
+}
+
+bool AnalysisCache::isComplete() const
+{
+    if (m_seconds.isEmpty())
+        return false;
+
+    for (const Second &second : m_seconds) {
+        if (!second.flags)
+            return false;
+    }
+    return true;
+}
+
+void AnalysisCache::addFrame(qint64 startTime, const QVector<quint32> &counts)
+{
+    addCounts(&m_video, startTime, counts);
+}
+
+void AnalysisCache::addLevels(qint64 startTime, const QVector<qreal> &levels)
+{
+    addPeak(&m_audio, startTime, levels);
+}
+
+// Frames of a second are summed up and folded into the second once a frame
+// of another second arrives.
+void AnalysisCache::addCounts(PendingVideo *pending, qint64 startTime, const QVector<quint32> &counts)
+{
+    if (startTime < 0 || counts.isEmpty() || m_seconds.isEmpty())
+        return;
+
+    int second = int(startTime / 1000000);
+    if (second >= m_seconds.size())
+        return;
+
+    if (second != pending->second) {
+        commitVideo(pending);
+        *pending = PendingVideo();
+        pending->second = second;
+    }
+
+    const int levels = counts.size();
+    for (int i = 0; i < levels; ++i) {
+        pending->lumaSum += quint64(counts[i]) * ((2 * i + 1) * 128 / levels);
+        pending->samples += counts[i];
+        pending->bins[i * HistogramBins / levels] += counts[i];
+    }
+}
+
+void AnalysisCache::addPeak(PendingAudio *pending, qint64 startTime, const QVector<qreal> &levels)
+{
+    if (startTime < 0 || levels.isEmpty() || m_seconds.isEmpty())
+        return;
+
+    int second = int(startTime / 1000000);
+    if (second >= m_seconds.size())
+        return;
+
+    if (second != pending->second) {
+        commitAudio(pending);
+        *pending = PendingAudio();
+        pending->second = second;
+    }
+
+    for (qreal level : levels)
+        pending->peak = qMax(pending->peak, level);
+}
+
+void AnalysisCache::commitVideo(PendingVideo *pending)
+{
+    if (pending->second < 0 || pending->second >= m_seconds.size() || !pending->samples)
+        return;
+
+    Second &second = m_seconds[pending->second];
+    second.flags |= HasVideo;
+    second.luma = quint8(qMin<quint64>(255, pending->lumaSum / pending->samples));
+
+    quint64 maxValue = 0;
+    for (quint64 count : pending->bins)
+        maxValue = qMax(maxValue, count);
+    for (int i = 0; i < HistogramBins; ++i)
+        second.histogram[i] = quint8(maxValue ? pending->bins[i] * 255 / maxValue : 0);
+
+    secondChanged(pending->second);
+}
+
+void AnalysisCache::commitAudio(PendingAudio *pending)
+{
+    if (pending->second < 0 || pending->second >= m_seconds.size())
+        return;
+
+    Second &second = m_seconds[pending->second];
+    second.flags |= HasAudio;
+    second.loudness = quint8(qBound(0, qRound(pending->peak * 255), 255));
+
+    secondChanged(pending->second);
+}
+
+void AnalysisCache::secondChanged(int second)
+{
+    m_dirty = true;
+    if (!m_saveTimer.isActive())
+        m_saveTimer.start();
+    emit secondsChanged(second, second);
+}
+
+// Decodes the whole media in the background, faster than real time, to fill
+// in the seconds playback has not reached.
+void AnalysisCache::startScan()
+{
+    m_scan = new AnalysisJob(m_url, nullptr, this);
+    m_scan->setLevels(HistogramBins);
+    m_scan->setPlaybackRate(m_scanRate);
+
+    AnalysisJob *scan = m_scan;
+    connect(scan, &AnalysisJob::frameAnalyzed, this, [this](qint64 startTime, const QVector<quint32> &counts) {
+        addCounts(&m_scanVideo, startTime, counts);
+    });
+    connect(scan, &AnalysisJob::levelsReady, this, [this](qint64 startTime, const QVector<qreal> &levels) {
+        addPeak(&m_scanAudio, startTime, levels);
+    });
+    connect(scan, &AnalysisJob::finished, this, [this, scan]() {
+        // The worker's last results are still queued to the job; deliver
+        // them before committing, while the seconds still belong to its media.
+        QCoreApplication::sendPostedEvents(scan, QEvent::MetaCall);
+        disconnect(scan, nullptr, this, nullptr);
+        commitVideo(&m_scanVideo);
+        commitAudio(&m_scanAudio);
+        m_scanVideo = PendingVideo();
+        m_scanAudio = PendingAudio();
+        m_scan = nullptr;
+        scan->deleteLater();
+        emit scanFinished(isComplete());
+    });
+
+    m_scan->start();
+}
+
+void AnalysisCache::stopScan()
+{
+    if (!m_scan)
+        return;
+
+    disconnect(m_scan, nullptr, this, nullptr);
+    m_scan->abort();
+    m_scan->deleteLater();
+    m_scan = nullptr;
+    m_scanVideo = PendingVideo();
+    m_scanAudio = PendingAudio();
+}
+
+void AnalysisCache::flush()
+{
+    commitVideo(&m_video);
+    commitAudio(&m_audio);
+    m_video = PendingVideo();
+    m_audio = PendingAudio();
+
+    m_saveTimer.stop();
+    if (m_dirty && save())
+        m_dirty = false;
+}
+
+bool AnalysisCache::load(const QString &fileName, QVector<Second> *seconds)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray data = file.readAll();
+    if (data.size() < HeaderSize)
+        return false;
+
+    const uchar *cur = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 count = qFromLittleEndian<quint32>(cur + 8);
+    if (qFromLittleEndian<quint32>(cur) != AnalysisMagic
+            || qFromLittleEndian<quint16>(cur + 4) != AnalysisVersion
+            || qFromLittleEndian<quint16>(cur + 6) != HistogramBins
+            || quint64(data.size()) < HeaderSize + quint64(count) * SecondSize) {
+        return false;
+    }
+
+    seconds->resize(int(count));
+    cur += HeaderSize;
+    for (Second &second : *seconds) {
+        second.flags = cur[0];
+        second.luma = cur[1];
+        second.loudness = cur[2];
+        memcpy(second.histogram, cur + 3, HistogramBins);
+        cur += SecondSize;
+    }
+    return true;
+}
+
+bool AnalysisCache::save()
+{
+    if (m_fileName.isEmpty())
+        return false;
+
+    QByteArray data(HeaderSize + m_seconds.size() * SecondSize, Qt::Uninitialized);
+    uchar *cur = reinterpret_cast<uchar *>(data.data());
+    qToLittleEndian<quint32>(AnalysisMagic, cur);
+    qToLittleEndian<quint16>(AnalysisVersion, cur + 4);
+    qToLittleEndian<quint16>(HistogramBins, cur + 6);
+    qToLittleEndian<quint32>(quint32(m_seconds.size()), cur + 8);
+
+    cur += HeaderSize;
+    for (const Second &second : qAsConst(m_seconds)) {
+        cur[0] = second.flags;
+        cur[1] = second.luma;
+        cur[2] = second.loudness;
+        memcpy(cur + 3, second.histogram, HistogramBins);
+        cur += SecondSize;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(data);
+    return file.commit();
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+class AnalysisJob;
+
+// Per-second analysis summaries of a media, persisted across runs.
+//
+// Every second holds the mean luma, a coarse luma histogram and the audio
+// peak level, filled in from the live probe results as the media plays and
+// from a background scan of local files. The summaries are stored in the
+// cache location under the media's content fingerprint, so a replayed file
+// has its overview right away.
+//
+// File layout (little-endian): magic, version, bins, second count, then per
+// second: flags, luma, loudness, histogram[bins].
+class AnalysisCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int HistogramBins = 16;
+
+    enum Flag
+    {
+        HasVideo = 0x1,
+        HasAudio = 0x2
+    };
+
+    struct Second
+    {
+        quint8 flags = 0;
+        quint8 luma = 0;        // mean, 0-255
+        quint8 loudness = 0;    // peak level of all channels, 0-255
+        quint8 histogram[HistogramBins] = {}; // relative to the largest bin
+    };
+
+    explicit AnalysisCache(QObject *parent = nullptr);
+    ~AnalysisCache();
+
+    void setMedia(const QUrl &url, qint64 duration);
+    QUrl url() const { return m_url; }
+
+    // Playback rate of the background scan, 0 disables it.
+    qreal scanRate() const { return m_scanRate; }
+    void setScanRate(qreal rate) { m_scanRate = rate; }
+    bool isScanning() const { return m_scan != nullptr; }
+
+    int secondCount() const { return m_seconds.size(); }
+    const QVector<Second> &seconds() const { return m_seconds; }
+    bool isComplete() const;
+
+public slots:
+    void addFrame(qint64 startTime, const QVector<quint32> &counts);
+    void addLevels(qint64 startTime, const QVector<qreal> &levels);
+    void flush();
+
+signals:
+    void loaded(bool complete);
+    void scanFinished(bool complete);
+    void secondsChanged(int first, int last);
+
+private:
+    struct PendingVideo
+    {
+        int second = -1;
+        quint64 lumaSum = 0;
+        quint64 samples = 0;
+        quint64 bins[HistogramBins] = {};
+    };
+
+    struct PendingAudio
+    {
+        int second = -1;
+        qreal peak = 0;
+    };
+
+    static bool load(const QString &fileName, QVector<Second> *seconds);
+    void mediaLoaded(int generation, const QString &fileName, const QVector<Second> &seconds);
+    bool save();
+    void addCounts(PendingVideo *pending, qint64 startTime, const QVector<quint32> &counts);
+    void addPeak(PendingAudio *pending, qint64 startTime, const QVector<qreal> &levels);
+    void commitVideo(PendingVideo *pending);
+    void commitAudio(PendingAudio *pending);
+    void secondChanged(int second);
+    void startScan();
+    void stopScan();
+
+    QUrl m_url;
+    int m_generation = 0;
+    QString m_fileName;
+    QVector<Second> m_seconds;
+    PendingVideo m_video;
+    PendingAudio m_audio;
+    AnalysisJob *m_scan = nullptr;
+    PendingVideo m_scanVideo;
+    PendingAudio m_scanAudio;
+    qreal m_scanRate = 8.0;
+    bool m_dirty = false;
+    QTimer m_saveTimer;
+};
+
+#endif // ANALYSISCACHE_H
\ No newline at end of file
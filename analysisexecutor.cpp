@@ -0,0 +1,141 @@
+#include "analysisexecutor.h"
+
+#include <QThread>
+
+Q_GLOBAL_STATIC(AnalysisExecutor, globalExecutor)
+
+class ExecutorThread : public QThread
+{
+public:
+    ExecutorThread(AnalysisExecutor *executor, int index)
+        : m_executor(executor)
+        , m_index(index)
+    {
+        setObjectName(QString("Analysis%1").arg(index));
+    }
+
+protected:
+    void run() override { m_executor->run(m_index); }
+
+private:
+    AnalysisExecutor *m_executor;
+    int m_index;
+};
+
+AnalysisExecutor *AnalysisExecutor::instance()
+{
+    return globalExecutor();
+}
+
+AnalysisExecutor::AnalysisExecutor()
+{
+    m_maxThreads = qMax(1, QThread::idealThreadCount());
+}
+
+AnalysisExecutor::~AnalysisExecutor()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_workAvailable.wakeAll();
+        m_limitChanged.wakeAll();
+    }
+
+    for (QThread *thread : qAsConst(m_threads))
+        thread->wait();
+    qDeleteAll(m_threads);
+}
+
+int AnalysisExecutor::maxThreads() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxThreads;
+}
+
+// Threads above the limit finish their task and then park on their own
+// condition, so wakeOne() for new work only reaches threads allowed to run
+// it and the limit can change at any time.
+void AnalysisExecutor::setMaxThreads(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxThreads = qMax(1, count);
+    if (!m_threads.isEmpty())
+        startThreads(m_maxThreads);
+    m_workAvailable.wakeAll();
+    m_limitChanged.wakeAll();
+}
+
+void AnalysisExecutor::submit(const void *source, const std::function<void()> &task)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_threads.isEmpty())
+        startThreads(m_maxThreads);
+
+    Source &entry = m_sources[source];
+    entry.tasks.enqueue(task);
+    if (!entry.running && entry.tasks.size() == 1) {
+        m_ready.enqueue(source);
+        m_workAvailable.wakeOne();
+    }
+}
+
+void AnalysisExecutor::cancel(const void *source)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_sources.find(source);
+    if (it == m_sources.end())
+        return;
+
+    it->tasks.clear();
+    m_ready.removeAll(source);
+    while (m_sources.contains(source) && m_sources.value(source).running)
+        m_sourceIdle.wait(&m_mutex);
+    m_sources.remove(source);
+}
+
+void AnalysisExecutor::startThreads(int count)
+{
+    while (m_threads.size() < count) {
+        QThread *thread = new ExecutorThread(this, m_threads.size());
+        thread->start(QThread::LowestPriority);
+        m_threads.append(thread);
+    }
+}
+
+void AnalysisExecutor::run(int index)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_stopping) {
+        if (index >= m_maxThreads) {
+            m_limitChanged.wait(&m_mutex);
+            continue;
+        }
+        if (m_ready.isEmpty()) {
+            m_workAvailable.wait(&m_mutex);
+            continue;
+        }
+
+        const void *source = m_ready.dequeue();
+        Source &entry = m_sources[source];
+        std::function<void()> task = entry.tasks.dequeue();
+        entry.running = true;
+
+        locker.unlock();
+        task();
+        task = nullptr;
+        locker.relock();
+
+        // Back to the end of the line, behind the other sources.
+        auto it = m_sources.find(source);
+        if (it != m_sources.end()) {
+            it->running = false;
+            if (!it->tasks.isEmpty()) {
+                m_ready.enqueue(source);
+                m_workAvailable.wakeOne();
+            } else {
+                m_sources.erase(it);
+            }
+        }
+        m_sourceIdle.wakeAll();
+    }
+}
\ No newline at end of file
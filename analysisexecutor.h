@@ -0,0 +1,60 @@
+#ifndef ANALYSISEXECUTOR_H
+#define ANALYSISEXECUTOR_H
+
+#include <QHash>
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+// Process-wide pool running the analysis of all histograms, meters and scopes.
+//
+// Tasks are submitted for a source (the analyzing object). The tasks of one
+// source run one at a time and in order, so sources keep their state without
+// locking; sources with pending work take turns, so a busy source cannot
+// starve the others. The pool is sized to the cores and at most maxThreads()
+// of its threads run tasks, which bounds the CPU used by the analysis.
+class AnalysisExecutor
+{
+public:
+    static AnalysisExecutor *instance();
+
+    AnalysisExecutor();
+    ~AnalysisExecutor();
+
+    int maxThreads() const;
+    void setMaxThreads(int count);
+
+    void submit(const void *source, const std::function<void()> &task);
+    // Drops the queued tasks of the source and waits for its running one.
+    void cancel(const void *source);
+
+private:
+    struct Source
+    {
+        QQueue<std::function<void()>> tasks;
+        bool running = false;
+    };
+
+    friend class ExecutorThread;
+    void run(int index);
+    void startThreads(int count);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_workAvailable;
+    QWaitCondition m_limitChanged;
+    QWaitCondition m_sourceIdle;
+    QHash<const void *, Source> m_sources;
+    QQueue<const void *> m_ready;
+    QVector<QThread *> m_threads;
+    int m_maxThreads = 1;
+    bool m_stopping = false;
+};
+
+#endif // ANALYSISEXECUTOR_H
\ No newline at end of file
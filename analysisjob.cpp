@@ -0,0 +1,182 @@
+#include "analysisjob.h"
+#include "analysiswriter.h"
+#include "frameanalysis.h"
+#include "videoframesurface.h"
+
+#include <QAudioProbe>
+
+static const int MaxFramesInFlight = 8;
+
+AnalysisWorker::AnalysisWorker(const QUrl &url, AnalysisWriter *writer, int levels)
+    : m_url(url)
+    , m_writer(writer)
+    , m_levels(levels)
+{
+}
+
+void AnalysisWorker::processFrame(QVideoFrame frame)
+{
+    const QVector<quint32> counts = computeHistogramCounts(frame, m_levels);
+    if (m_writer)
+        m_writer->writeHistogram(m_url, frame.startTime(), normalizeHistogram(counts));
+    emit frameAnalyzed(frame.startTime(), counts);
+}
+
+void AnalysisWorker::processBuffer(QAudioBuffer buffer)
+{
+    const QVector<qreal> levels = getBufferLevels(buffer);
+    if (m_writer)
+        m_writer->writeLevels(m_url, buffer.startTime(), levels);
+    emit levelsReady(buffer.startTime(), levels);
+}
+
+void AnalysisWorker::flush()
+{
+    if (m_writer)
+        m_writer->flush();
+}
+
+AnalysisJob::AnalysisJob(const QUrl &url, AnalysisWriter *writer, QObject *parent)
+    : QObject(parent)
+    , m_url(url)
+    , m_writer(writer)
+{
+    qRegisterMetaType<QAudioBuffer>("QAudioBuffer");
+    qRegisterMetaType<QVector<quint32>>("QVector<quint32>");
+    qRegisterMetaType<QVector<qreal>>("QVector<qreal>");
+
+    m_surface = new VideoFrameSurface(this);
+    // Planar YUV first: the histogram only needs the Y plane as it is.
+    m_surface->setPixelFormats(QList<QVideoFrame::PixelFormat>()
+                               << QVideoFrame::Format_YUV420P
+                               << QVideoFrame::Format_NV12
+                               << QVideoFrame::Format_YV12
+                               << QVideoFrame::Format_NV21
+                               << QVideoFrame::Format_UYVY
+                               << QVideoFrame::Format_YUYV
+                               << QVideoFrame::Format_RGB32
+                               << QVideoFrame::Format_ARGB32);
+
+    m_player = new QMediaPlayer(this);
+    m_player->setMuted(true);
+    m_player->setVideoOutput(m_surface);
+
+    m_audioProbe = new QAudioProbe(this);
+    m_audioProbe->setSource(m_player);
+
+    connect(m_surface, &VideoFrameSurface::frameAvailable, this, &AnalysisJob::processFrame);
+    connect(m_audioProbe, &QAudioProbe::audioBufferProbed, this, &AnalysisJob::processBuffer);
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &AnalysisJob::statusChanged);
+    connect(m_player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, &AnalysisJob::displayError);
+}
+
+AnalysisJob::~AnalysisJob()
+{
+    m_player->stop();
+    stopWorker();
+}
+
+void AnalysisJob::start()
+{
+    m_worker = new AnalysisWorker(m_url, m_writer, m_levels);
+    m_worker->moveToThread(&m_workerThread);
+    connect(m_worker, &AnalysisWorker::frameAnalyzed, this, &AnalysisJob::frameAnalyzed);
+    connect(m_worker, &AnalysisWorker::frameAnalyzed, this, &AnalysisJob::frameDone);
+    connect(m_worker, &AnalysisWorker::levelsReady, this, &AnalysisJob::levelsReady);
+    m_workerThread.start();
+
+    m_player->setMedia(QMediaContent(m_url));
+    m_player->setPlaybackRate(m_playbackRate);
+    m_player->play();
+}
+
+void AnalysisJob::abort()
+{
+    m_errorString = tr("Aborted");
+    m_finished = true;
+    m_player->stop();
+    stopWorker();
+}
+
+void AnalysisJob::processFrame(const QVideoFrame &frame)
+{
+    if (m_finished)
+        return;
+
+    ++m_frameCount;
+    ++m_framesInFlight;
+    QMetaObject::invokeMethod(m_worker, "processFrame", Qt::QueuedConnection, Q_ARG(QVideoFrame, frame));
+
+    // Each queued frame holds a decoded buffer; frames the player delivers
+    // while pausing are still queued.
+    if (!m_throttled && m_framesInFlight >= MaxFramesInFlight) {
+        m_throttled = true;
+        m_player->pause();
+    }
+}
+
+void AnalysisJob::frameDone()
+{
+    --m_framesInFlight;
+    if (m_throttled && !m_finished && m_framesInFlight <= MaxFramesInFlight / 2) {
+        m_throttled = false;
+        m_player->play();
+    }
+}
+
+void AnalysisJob::processBuffer(const QAudioBuffer &buffer)
+{
+    if (m_finished)
+        return;
+
+    ++m_bufferCount;
+    QMetaObject::invokeMethod(m_worker, "processBuffer", Qt::QueuedConnection, Q_ARG(QAudioBuffer, buffer));
+}
+
+void AnalysisJob::statusChanged(QMediaPlayer::MediaStatus status)
+{
+    switch (status) {
+    case QMediaPlayer::EndOfMedia:
+        finish(true);
+        break;
+    case QMediaPlayer::InvalidMedia:
+        displayError();
+        break;
+    default:
+        break;
+    }
+}
+
+void AnalysisJob::displayError()
+{
+    m_errorString = m_player->errorString();
+    if (m_errorString.isEmpty())
+        m_errorString = tr("Invalid media");
+    finish(false);
+}
+
+void AnalysisJob::finish(bool ok)
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    m_player->stop();
+    stopWorker();
+    emit finished(ok);
+}
+
+// Lets the worker drain what is already queued, then stops its thread.
+void AnalysisJob::stopWorker()
+{
+    if (!m_worker)
+        return;
+
+    if (m_workerThread.isRunning()) {
+        QMetaObject::invokeMethod(m_worker, "flush", Qt::BlockingQueuedConnection);
+        m_workerThread.quit();
+        m_workerThread.wait();
+    }
+    delete m_worker;
+    m_worker = nullptr;
+}
\ No newline at end of file
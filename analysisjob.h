@@ -0,0 +1,98 @@
+#ifndef ANALYSISJOB_H
+#define ANALYSISJOB_H
+
+#include <QAudioBuffer>
+#include <QMediaPlayer>
+#include <QObject>
+#include <QThread>
+#include <QUrl>
+#include <QVideoFrame>
+
+QT_BEGIN_NAMESPACE
+class QAudioProbe;
+QT_END_NAMESPACE
+
+class AnalysisWriter;
+class VideoFrameSurface;
+
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    AnalysisWorker(const QUrl &url, AnalysisWriter *writer, int levels);
+
+public slots:
+    void processFrame(QVideoFrame frame);
+    void processBuffer(QAudioBuffer buffer);
+    void flush();
+
+signals:
+    void frameAnalyzed(qint64 startTime, const QVector<quint32> &counts);
+    void levelsReady(qint64 startTime, const QVector<qreal> &levels);
+
+private:
+    QUrl m_url;
+    AnalysisWriter *m_writer;
+    int m_levels;
+};
+
+// Plays one media without any widgets and runs the histogram and audio
+// level kernels on every frame and buffer, streaming the results to a writer
+// (if any) and emitting them. The kernels and the writer run on the job's own
+// thread, so several jobs analyze in parallel. Every frame is analyzed: when
+// the kernels fall behind the decoder, playback pauses until the worker has
+// caught up instead of queueing decoded frames without bound.
+class AnalysisJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisJob(const QUrl &url, AnalysisWriter *writer = nullptr, QObject *parent = nullptr);
+    ~AnalysisJob();
+
+    QUrl url() const { return m_url; }
+    QString errorString() const { return m_errorString; }
+    qint64 frameCount() const { return m_frameCount; }
+    qint64 bufferCount() const { return m_bufferCount; }
+
+    void setLevels(int levels) { m_levels = levels; }
+    void setPlaybackRate(qreal rate) { m_playbackRate = rate; }
+
+    void start();
+    void abort();
+
+signals:
+    void frameAnalyzed(qint64 startTime, const QVector<quint32> &counts);
+    void levelsReady(qint64 startTime, const QVector<qreal> &levels);
+    void finished(bool ok);
+
+private slots:
+    void processFrame(const QVideoFrame &frame);
+    void processBuffer(const QAudioBuffer &buffer);
+    void statusChanged(QMediaPlayer::MediaStatus status);
+    void displayError();
+
+private:
+    void finish(bool ok);
+    void stopWorker();
+    void frameDone();
+
+    QUrl m_url;
+    AnalysisWriter *m_writer = nullptr;
+    QMediaPlayer *m_player = nullptr;
+    VideoFrameSurface *m_surface = nullptr;
+    QAudioProbe *m_audioProbe = nullptr;
+    AnalysisWorker *m_worker = nullptr;
+    QThread m_workerThread;
+    QString m_errorString;
+    int m_levels = 128;
+    qreal m_playbackRate = 4.0;
+    qint64 m_frameCount = 0;
+    qint64 m_bufferCount = 0;
+    int m_framesInFlight = 0;
+    bool m_throttled = false;
+    bool m_finished = false;
+};
+
+#endif // ANALYSISJOB_H
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "analysispresenter.h"
+#include "perfcounters.h"
+
+#include <QMediaPlayer>
+
+AnalysisPresenter::AnalysisPresenter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void AnalysisPresenter::setPlayer(QMediaPlayer *player)
+{
+    m_player = player;
+}
+
+bool AnalysisPresenter::isCurrent(qint64 startTime) const
+{
+    if (!m_player || m_maxLatency <= 0 || startTime < 0)
+        return true;
+
+    // The position runs rate times faster than the wall clock.
+    const qreal rate = m_player->playbackRate() > 0 ? m_player->playbackRate() : 1.0;
+    const qint64 lag = qint64((m_player->position() - startTime / 1000) / rate);
+    if (lag > 0)
+        PerfCounters::addSample(PerfCounters::ResultLatency, lag * 1000000);
+
+    if (lag <= m_maxLatency)
+        return true;
+
+    PerfCounters::increment(PerfCounters::StaleResults);
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef ANALYSISPRESENTER_H
+#define ANALYSISPRESENTER_H
+
+#include <QObject>
+#include <QPointer>
+
+QT_BEGIN_NAMESPACE
+class QMediaPlayer;
+QT_END_NAMESPACE
+
+// Decides whether an analysis result is still worth showing. Results carry
+// the start time of their frame or buffer; one that trails the player's
+// position by more than maxLatency() of wall time is stale and gets dropped,
+// so a slow analysis shows fewer results instead of late ones.
+class AnalysisPresenter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisPresenter(QObject *parent = nullptr);
+
+    void setPlayer(QMediaPlayer *player);
+
+    int maxLatency() const { return m_maxLatency; }
+    void setMaxLatency(int msecs) { m_maxLatency = msecs; }
+
+    // startTime in microseconds, as in QVideoFrame and QAudioBuffer.
+    bool isCurrent(qint64 startTime) const;
+
+private:
+    QPointer<QMediaPlayer> m_player;
+    int m_maxLatency = 250;
+};
+
+#endif // ANALYSISPRESENTER_H
\ No newline at end of file
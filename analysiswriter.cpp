@@ -0,0 +1,123 @@
+#include "analysiswriter.h"
+
+#include <QtEndian>
+
+#include <cstdio>
+#include <cstring>
+
+static const quint32 AnalysisMagic = 0x4e415651; // "QVAN"
+static const quint16 AnalysisVersion = 1;
+
+enum RecordKind : quint8
+{
+    SourceRecord = 0,
+    VideoRecord = 1,
+    AudioRecord = 2
+};
+
+template <class T>
+static void appendValue(QByteArray &data, T value)
+{
+    const int offset = data.size();
+    data.resize(offset + int(sizeof(T)));
+    qToLittleEndian<T>(value, data.data() + offset);
+}
+
+AnalysisWriter::~AnalysisWriter()
+{
+    close();
+}
+
+bool AnalysisWriter::open(const QString &fileName, Format format)
+{
+    close();
+    m_format = format;
+
+    bool ok;
+    if (fileName == QLatin1String("-")) {
+        ok = m_file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        m_file.setFileName(fileName);
+        ok = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!ok)
+        return false;
+
+    if (m_format == Binary) {
+        QByteArray header;
+        appendValue<quint32>(header, AnalysisMagic);
+        appendValue<quint16>(header, AnalysisVersion);
+        m_file.write(header);
+    } else {
+        m_file.write("url,stream,time_us,values\n");
+    }
+    return true;
+}
+
+void AnalysisWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.flush();
+        m_file.close();
+    }
+    m_source.clear();
+}
+
+void AnalysisWriter::flush()
+{
+    if (m_file.isOpen())
+        m_file.flush();
+}
+
+void AnalysisWriter::writeHistogram(const QUrl &source, qint64 startTime, const QVector<qreal> &histogram)
+{
+    writeRecord(VideoRecord, source, startTime, histogram);
+}
+
+void AnalysisWriter::writeLevels(const QUrl &source, qint64 startTime, const QVector<qreal> &levels)
+{
+    writeRecord(AudioRecord, source, startTime, levels);
+}
+
+void AnalysisWriter::writeRecord(quint8 kind, const QUrl &source, qint64 startTime, const QVector<qreal> &values)
+{
+    if (!m_file.isOpen())
+        return;
+
+    m_record.clear();
+
+    if (source != m_source) {
+        m_source = source;
+        QByteArray url = source.toEncoded();
+        if (m_format == Binary) {
+            appendValue<quint8>(m_record, SourceRecord);
+            appendValue<quint32>(m_record, quint32(url.size()));
+            m_record.append(url);
+        } else {
+            m_csvSource = '"' + url.replace('"', "\"\"") + '"';
+        }
+    }
+
+    if (m_format == Binary) {
+        appendValue<quint8>(m_record, kind);
+        appendValue<qint64>(m_record, startTime);
+        appendValue<quint16>(m_record, quint16(qMin(values.size(), 0xffff)));
+        for (int i = 0; i < values.size() && i < 0xffff; ++i) {
+            float value = float(values.at(i));
+            quint32 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            appendValue<quint32>(m_record, bits);
+        }
+    } else {
+        m_record.append(m_csvSource);
+        m_record.append(kind == VideoRecord ? ",video," : ",audio,");
+        m_record.append(QByteArray::number(startTime));
+        for (qreal value : values) {
+            m_record.append(',');
+            m_record.append(QByteArray::number(value, 'g', 6));
+        }
+        m_record.append('\n');
+    }
+
+    m_file.write(m_record);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef ANALYSISWRITER_H
+#define ANALYSISWRITER_H
+
+#include <QFile>
+#include <QUrl>
+#include <QVector>
+
+// Streams per-frame and per-buffer statistics to a file (or stdout for "-").
+//
+// Csv rows are "url,stream,time_us,value,...", with stream being "video"
+// (histogram bins) or "audio" (per channel levels).
+//
+// Binary records (little-endian, after a "QVAN" magic and version):
+//   quint8 kind (0 = source, 1 = video, 2 = audio)
+//   source: quint32 length, utf-8 url
+//   video/audio: qint64 time_us, quint16 count, float values[count]
+// A source record precedes the records of each media.
+class AnalysisWriter
+{
+public:
+    enum Format
+    {
+        Csv,
+        Binary
+    };
+
+    AnalysisWriter() = default;
+    ~AnalysisWriter();
+
+    bool open(const QString &fileName, Format format);
+    void close();
+    void flush();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void writeHistogram(const QUrl &source, qint64 startTime, const QVector<qreal> &histogram);
+    void writeLevels(const QUrl &source, qint64 startTime, const QVector<qreal> &levels);
+
+private:
+    void writeRecord(quint8 kind, const QUrl &source, qint64 startTime, const QVector<qreal> &values);
+
+    QFile m_file;
+    Format m_format = Csv;
+    QUrl m_source;
+    QByteArray m_csvSource;
+    QByteArray m_record;
+};
+
+#endif // ANALYSISWRITER_H
\ No newline at end of file
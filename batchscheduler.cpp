@@ -0,0 +1,155 @@
+#include "batchscheduler.h"
+#include "analysisjob.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QTimer>
+
+BatchScheduler::BatchScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BatchScheduler::~BatchScheduler()
+{
+    for (Running *running : qAsConst(m_running)) {
+        delete running->job;
+        delete running->writer;
+        delete running;
+    }
+}
+
+bool BatchScheduler::start(const QList<QUrl> &urls)
+{
+    if (!QDir().mkpath(m_outputDirectory))
+        return false;
+
+    if (m_manifestFile.isEmpty())
+        m_manifestFile = QDir(m_outputDirectory).filePath("manifest.tsv");
+
+    loadManifest();
+
+    m_manifest.setFileName(m_manifestFile);
+    if (!m_manifest.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return false;
+
+    for (const QUrl &url : urls) {
+        if (!m_done.contains(url) && !m_queue.contains(url))
+            m_queue.append(url);
+    }
+
+    QTimer::singleShot(0, this, &BatchScheduler::dispatch);
+    return true;
+}
+
+void BatchScheduler::loadManifest()
+{
+    QFile file(m_manifestFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd()) {
+        QStringList fields = in.readLine().split('\t');
+        if (fields.size() >= 2 && fields.at(0) == QLatin1String("ok"))
+            m_done.insert(QUrl(fields.at(1)));
+    }
+}
+
+void BatchScheduler::dispatch()
+{
+    while (m_running.size() < m_maxJobs && !m_queue.isEmpty())
+        startJob(m_queue.takeFirst());
+
+    if (m_running.isEmpty() && m_queue.isEmpty() && m_manifest.isOpen()) {
+        m_manifest.close();
+        emit finished(m_failures);
+    }
+}
+
+void BatchScheduler::startJob(const QUrl &url)
+{
+    Running *running = new Running;
+    running->url = url;
+    running->elapsed.start();
+    running->output = outputFileName(url);
+    running->writer = new AnalysisWriter;
+    if (!running->writer->open(running->output, m_format)) {
+        delete running->writer;
+        running->writer = nullptr;
+        m_running.append(running);
+        qWarning().noquote() << "Cannot open" << running->output;
+        finishJob(running, "failed");
+        return;
+    }
+
+    running->job = new AnalysisJob(url, running->writer);
+    running->job->setLevels(m_levels);
+    running->job->setPlaybackRate(m_playbackRate);
+    connect(running->job, &AnalysisJob::finished, this, [this, running](bool ok) {
+        if (!ok)
+            qWarning().noquote() << running->url.toString() << running->job->errorString();
+        finishJob(running, ok ? "ok" : "failed");
+    });
+
+    if (m_jobTimeout > 0) {
+        running->timer = new QTimer(running->job);
+        running->timer->setSingleShot(true);
+        connect(running->timer, &QTimer::timeout, this, [this, running]() {
+            qWarning().noquote() << running->url.toString() << "timed out";
+            running->job->abort();
+            finishJob(running, "timeout");
+        });
+        running->timer->start(m_jobTimeout);
+    }
+
+    m_running.append(running);
+    running->job->start();
+}
+
+void BatchScheduler::finishJob(Running *running, const QString &status)
+{
+    m_running.removeOne(running);
+
+    qint64 frames = 0;
+    qint64 buffers = 0;
+    if (running->job) {
+        if (running->timer)
+            running->timer->stop();
+        frames = running->job->frameCount();
+        buffers = running->job->bufferCount();
+        running->job->deleteLater();
+    }
+
+    // The job's worker is stopped by now, so the writer can be closed.
+    delete running->writer;
+
+    if (status != QLatin1String("ok"))
+        ++m_failures;
+
+    QTextStream out(&m_manifest);
+    out.setCodec("UTF-8");
+    out << status << '\t' << running->url.toString() << '\t' << running->output << '\t'
+        << frames << '\t' << buffers << '\t' << running->elapsed.elapsed() << '\n';
+    out.flush();
+    m_manifest.flush();
+
+    delete running;
+
+    QTimer::singleShot(0, this, &BatchScheduler::dispatch);
+}
+
+// Named after the media file, with a short url hash so that equally named
+// files from different folders do not collide.
+QString BatchScheduler::outputFileName(const QUrl &url) const
+{
+    QString base = QFileInfo(url.path()).completeBaseName();
+    if (base.isEmpty())
+        base = "media";
+    QByteArray hash = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex().left(10);
+    QString suffix = m_format == AnalysisWriter::Binary ? ".qvan" : ".csv";
+    return QDir(m_outputDirectory).filePath(base + '-' + QString::fromLatin1(hash) + suffix);
+}
\ No newline at end of file
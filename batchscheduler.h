@@ -0,0 +1,78 @@
+#ifndef BATCHSCHEDULER_H
+#define BATCHSCHEDULER_H
+
+#include "analysiswriter.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+class AnalysisJob;
+
+// Runs headless analysis jobs for a list of media, a bounded number at a time.
+//
+// Every media gets its own output file in the output directory. Finished jobs
+// are appended to a tab separated manifest ("status, url, output, frames,
+// buffers, msecs"); urls already listed as "ok" are skipped on the next run,
+// so an interrupted batch resumes where it stopped.
+class BatchScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BatchScheduler(QObject *parent = nullptr);
+    ~BatchScheduler();
+
+    void setMaxJobs(int count) { m_maxJobs = qMax(1, count); }
+    void setJobTimeout(int msecs) { m_jobTimeout = msecs; }
+    void setOutputDirectory(const QString &path) { m_outputDirectory = path; }
+    void setManifestFile(const QString &fileName) { m_manifestFile = fileName; }
+    void setFormat(AnalysisWriter::Format format) { m_format = format; }
+    void setPlaybackRate(qreal rate) { m_playbackRate = rate; }
+    void setLevels(int levels) { m_levels = levels; }
+
+    bool start(const QList<QUrl> &urls);
+
+signals:
+    void finished(int failures);
+
+private:
+    struct Running
+    {
+        AnalysisJob *job = nullptr;
+        AnalysisWriter *writer = nullptr;
+        QTimer *timer = nullptr;
+        QUrl url;
+        QString output;
+        QElapsedTimer elapsed;
+    };
+
+    void loadManifest();
+    void dispatch();
+    void startJob(const QUrl &url);
+    void finishJob(Running *running, const QString &status);
+    QString outputFileName(const QUrl &url) const;
+
+    QList<QUrl> m_queue;
+    QList<Running *> m_running;
+    QSet<QUrl> m_done;
+    QFile m_manifest;
+
+    QString m_outputDirectory;
+    QString m_manifestFile;
+    AnalysisWriter::Format m_format = AnalysisWriter::Csv;
+    qreal m_playbackRate = 4.0;
+    int m_levels = 128;
+    int m_maxJobs = 1;
+    int m_jobTimeout = 0;
+    int m_failures = 0;
+};
+
+#endif // BATCHSCHEDULER_H
\ No newline at end of file
@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    kernels \
+    playlist
\ No newline at end of file
@@ -0,0 +1,34 @@
+TEMPLATE = app
+TARGET = tst_bench_kernels
+
+QT += testlib \
+      multimedia \
+      widgets
+
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+HEADERS = \
+    ../../analysisexecutor.h \
+    ../../analysispresenter.h \
+    ../../frameanalysis.h \
+    ../../histogramaccumulator.h \
+    ../../histogramkernels.h \
+    ../../histogramwidget.h \
+    ../../perfcounters.h \
+    ../../sceneanalyzer.h \
+    ../../tracer.h \
+    ../../videoframeview.h
+SOURCES = tst_bench_kernels.cpp \
+    ../../analysisexecutor.cpp \
+    ../../analysispresenter.cpp \
+    ../../frameanalysis.cpp \
+    ../../histogramaccumulator.cpp \
+    ../../histogramkernels.cpp \
+    ../../histogramwidget.cpp \
+    ../../perfcounters.cpp \
+    ../../sceneanalyzer.cpp \
+    ../../tracer.cpp \
+    ../../videoframeview.cpp
\ No newline at end of file
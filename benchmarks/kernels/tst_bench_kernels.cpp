@@ -0,0 +1,209 @@
+#include "frameanalysis.h"
+#include "histogramkernels.h"
+#include "histogramwidget.h"
+
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QVideoFrame>
+#include <QtTest>
+
+// Frames and buffers are filled with a fixed pseudo random pattern so runs
+// are comparable between machines and releases.
+static void fillPattern(uchar *data, int size)
+{
+    quint32 state = 0x12345678;
+    for (int i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        data[i] = uchar(state >> 24);
+    }
+}
+
+static QVideoFrame createFrame(QVideoFrame::PixelFormat format, const QSize &size)
+{
+    int bytesPerLine = format == QVideoFrame::Format_RGB32 ? size.width() * 4 : size.width();
+    int bytes = format == QVideoFrame::Format_RGB32
+            ? bytesPerLine * size.height()
+            : bytesPerLine * size.height() * 3 / 2;
+
+    QVideoFrame frame(bytes, size, bytesPerLine, format);
+    if (frame.map(QAbstractVideoBuffer::WriteOnly)) {
+        fillPattern(frame.bits(), frame.mappedBytes());
+        frame.unmap();
+    }
+    return frame;
+}
+
+static QAudioFormat audioFormat(QAudioFormat::SampleType type, int sampleSize, int channels)
+{
+    QAudioFormat format;
+    format.setCodec("audio/pcm");
+    format.setSampleRate(48000);
+    format.setByteOrder(QAudioFormat::LittleEndian);
+    format.setSampleType(type);
+    format.setSampleSize(sampleSize);
+    format.setChannelCount(channels);
+    return format;
+}
+
+class tst_bench_kernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void processFrame_data();
+    void processFrame();
+    void countHistogram_data();
+    void countHistogram();
+    void getBufferLevels_data();
+    void getBufferLevels();
+};
+
+void tst_bench_kernels::processFrame_data()
+{
+    QTest::addColumn<QVideoFrame::PixelFormat>("format");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("levels");
+
+    const QList<QPair<const char *, QVideoFrame::PixelFormat>> formats = {
+        { "YUV420P", QVideoFrame::Format_YUV420P },
+        { "NV12", QVideoFrame::Format_NV12 },
+        { "RGB32", QVideoFrame::Format_RGB32 }
+    };
+    const QList<QPair<const char *, QSize>> sizes = {
+        { "720p", QSize(1280, 720) },
+        { "1080p", QSize(1920, 1080) },
+        { "4K", QSize(3840, 2160) }
+    };
+    const QList<int> levels = { 16, 128, 256 };
+
+    for (const auto &format : formats) {
+        for (const auto &size : sizes) {
+            for (int level : levels) {
+                QTest::addRow("%s %s %d", format.first, size.first, level)
+                        << format.second << size.second << level;
+            }
+        }
+    }
+}
+
+void tst_bench_kernels::processFrame()
+{
+    QFETCH(QVideoFrame::PixelFormat, format);
+    QFETCH(QSize, size);
+    QFETCH(int, levels);
+
+    QVideoFrame frame = createFrame(format, size);
+    QVERIFY(frame.isValid());
+
+    FrameProcessor processor;
+    QVector<qreal> histogram;
+    connect(&processor, &FrameProcessor::histogramReady, this, [&histogram](qint64, const QVector<qreal> &result) {
+        histogram = result;
+    });
+
+    QBENCHMARK {
+        processor.processFrame(frame, levels);
+    }
+
+    QCOMPARE(histogram.size(), levels);
+}
+
+void tst_bench_kernels::countHistogram_data()
+{
+    QTest::addColumn<int>("storageBits");
+    QTest::addColumn<int>("significantBits");
+    QTest::addColumn<bool>("msbAligned");
+    QTest::addColumn<int>("levels");
+
+    for (int levels : { 256, 1024 }) {
+        QTest::addRow("8 bit, %d levels", levels) << 8 << 8 << false << levels;
+        QTest::addRow("10 bit lsb, %d levels", levels) << 16 << 10 << false << levels;
+        QTest::addRow("10 bit msb, %d levels", levels) << 16 << 10 << true << levels;
+        QTest::addRow("12 bit lsb, %d levels", levels) << 16 << 12 << false << levels;
+        QTest::addRow("12 bit msb, %d levels", levels) << 16 << 12 << true << levels;
+        QTest::addRow("16 bit, %d levels", levels) << 16 << 16 << false << levels;
+    }
+}
+
+// A 1080p luma plane through the integer kernels.
+void tst_bench_kernels::countHistogram()
+{
+    QFETCH(int, storageBits);
+    QFETCH(int, significantBits);
+    QFETCH(bool, msbAligned);
+    QFETCH(int, levels);
+
+    const int width = 1920;
+    const int height = 1080;
+    const int step = storageBits / 8;
+    QByteArray plane(width * height * step, Qt::Uninitialized);
+    fillPattern(reinterpret_cast<uchar *>(plane.data()), plane.size());
+
+    QVector<quint32> partials(4 * levels);
+    QVector<quint32> counts(levels);
+
+    QBENCHMARK {
+        partials.fill(0);
+        counts.fill(0);
+        const uchar *line = reinterpret_cast<const uchar *>(plane.constData());
+        for (int y = 0; y < height; ++y, line += width * step)
+            countHistogramLine(line, width, step, storageBits, significantBits, msbAligned, levels, partials.data());
+        mergeHistogramPartials(partials.constData(), levels, counts.data());
+    }
+
+    quint64 total = 0;
+    for (quint32 count : counts)
+        total += count;
+    QCOMPARE(total, quint64(width) * height);
+}
+
+void tst_bench_kernels::getBufferLevels_data()
+{
+    QTest::addColumn<QAudioFormat>("format");
+    QTest::addColumn<int>("frames");
+
+    const QList<QPair<const char *, QPair<QAudioFormat::SampleType, int>>> sampleFormats = {
+        { "u8", { QAudioFormat::UnSignedInt, 8 } },
+        { "u16", { QAudioFormat::UnSignedInt, 16 } },
+        { "u32", { QAudioFormat::UnSignedInt, 32 } },
+        { "s8", { QAudioFormat::SignedInt, 8 } },
+        { "s16", { QAudioFormat::SignedInt, 16 } },
+        { "s32", { QAudioFormat::SignedInt, 32 } },
+        { "f32", { QAudioFormat::Float, 32 } }
+    };
+    const QList<int> channelCounts = { 1, 2, 6, 8 };
+
+    for (const auto &sampleFormat : sampleFormats) {
+        for (int channels : channelCounts) {
+            QTest::addRow("%s %dch", sampleFormat.first, channels)
+                    << audioFormat(sampleFormat.second.first, sampleFormat.second.second, channels)
+                    << 4800;
+        }
+    }
+}
+
+void tst_bench_kernels::getBufferLevels()
+{
+    QFETCH(QAudioFormat, format);
+    QFETCH(int, frames);
+
+    QByteArray data(format.bytesForFrames(frames), Qt::Uninitialized);
+    fillPattern(reinterpret_cast<uchar *>(data.data()), data.size());
+    if (format.sampleType() == QAudioFormat::Float) {
+        float *samples = reinterpret_cast<float *>(data.data());
+        for (int i = 0; i < data.size() / int(sizeof(float)); ++i)
+            samples[i] = float(i % 2001 - 1000) / 1000.0f;
+    }
+    QAudioBuffer buffer(data, format);
+
+    QVector<qreal> levels;
+    QBENCHMARK {
+        levels = ::getBufferLevels(buffer);
+    }
+
+    QCOMPARE(levels.size(), format.channelCount());
+}
+
+QTEST_GUILESS_MAIN(tst_bench_kernels)
+
+#include "tst_bench_kernels.moc"
\ No newline at end of file
@@ -0,0 +1,21 @@
+TEMPLATE = app
+TARGET = tst_bench_playlist
+
+QT += testlib \
+      multimedia
+
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+HEADERS = \
+    ../../playlistmodel.h \
+    ../../metadatastore.h \
+    ../../perfcounters.h \
+    ../../tracer.h
+SOURCES = tst_bench_playlist.cpp \
+    ../../playlistmodel.cpp \
+    ../../metadatastore.cpp \
+    ../../perfcounters.cpp \
+    ../../tracer.cpp
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "metadatastore.h"
+#include "playlistmodel.h"
+
+#include <QMediaPlaylist>
+#include <QTemporaryDir>
+#include <QtTest>
+
+static const int MetadataFields = 14;
+static const int VisibleRows = 40;
+
+static QList<QMediaContent> createMedia(int count)
+{
+    QList<QMediaContent> media;
+    media.reserve(count);
+    for (int i = 0; i < count; ++i)
+        media.append(QMediaContent(QUrl::fromLocalFile(QString("/media/library/%1/clip-%2.mp4").arg(i % 97).arg(i))));
+    return media;
+}
+
+static PlaylistModel *createModel(int count)
+{
+    PlaylistModel *model = new PlaylistModel;
+    QMediaPlaylist *playlist = new QMediaPlaylist;
+    playlist->addMedia(createMedia(count));
+    model->setPlaylist(playlist);
+    return model;
+}
+
+static QStringList createRecord(int index)
+{
+    QStringList record;
+    record << QString("Title %1").arg(index);
+    for (int i = 1; i < MetadataFields; ++i)
+        record << QString("value %1.%2").arg(index).arg(i);
+    return record;
+}
+
+class tst_bench_playlist : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert_data();
+    void insert();
+    void scroll_data();
+    void scroll();
+    void remove_data();
+    void remove();
+    void setDataOverrides_data();
+    void setDataOverrides();
+
+    void metadataLookup_data();
+    void metadataLookup();
+    void metadataSave_data();
+    void metadataSave();
+    void metadataExport_data();
+    void metadataExport();
+
+private:
+    void playlistSizes();
+    void catalogSizes();
+    QString createCatalog(int records);
+
+    QTemporaryDir m_dir;
+};
+
+void tst_bench_playlist::playlistSizes()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void tst_bench_playlist::catalogSizes()
+{
+    QTest::addColumn<int>("records");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("50k") << 50000;
+}
+
+QString tst_bench_playlist::createCatalog(int records)
+{
+    QString fileName = m_dir.filePath(QString("DataQt-%1.txt").arg(records));
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        QTextStream stream(&file);
+        for (int k = 0; k < records; ++k) {
+            const QStringList record = createRecord(k);
+            for (const QString &field : record)
+                stream << field << ";";
+            stream << "/" << endl;
+        }
+    }
+    return fileName;
+}
+
+void tst_bench_playlist::insert_data()
+{
+    playlistSizes();
+}
+
+void tst_bench_playlist::insert()
+{
+    QFETCH(int, count);
+
+    const QList<QMediaContent> media = createMedia(count);
+    PlaylistModel model;
+    QMediaPlaylist *playlist = new QMediaPlaylist;
+    model.setPlaylist(playlist);
+
+    QBENCHMARK_ONCE {
+        playlist->addMedia(media);
+    }
+
+    QCOMPARE(model.rowCount(), count);
+}
+
+// Reads what a view shows on screen at a thousand positions spread over the
+// whole playlist.
+void tst_bench_playlist::scroll_data()
+{
+    playlistSizes();
+}
+
+void tst_bench_playlist::scroll()
+{
+    QFETCH(int, count);
+
+    QScopedPointer<PlaylistModel> model(createModel(count));
+    const int steps = 1000;
+
+    QBENCHMARK {
+        for (int step = 0; step < steps; ++step) {
+            int first = int(qint64(count - VisibleRows) * step / steps);
+            for (int row = first; row < first + VisibleRows; ++row) {
+                for (int column = 0; column < PlaylistModel::ColumnCount; ++column)
+                    model->data(model->index(row, column));
+            }
+        }
+    }
+}
+
+void tst_bench_playlist::remove_data()
+{
+    playlistSizes();
+}
+
+// Removes a hundred ranges of a hundred rows from the middle.
+void tst_bench_playlist::remove()
+{
+    QFETCH(int, count);
+
+    QScopedPointer<PlaylistModel> model(createModel(count));
+    QMediaPlaylist *playlist = model->playlist();
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < 100; ++i)
+            playlist->removeMedia(count / 2 - 5000, count / 2 - 4901);
+    }
+
+    QCOMPARE(model->rowCount(), count - 10000);
+}
+
+void tst_bench_playlist::setDataOverrides_data()
+{
+    playlistSizes();
+}
+
+// Renames a thousand rows, then reads them back.
+void tst_bench_playlist::setDataOverrides()
+{
+    QFETCH(int, count);
+
+    QScopedPointer<PlaylistModel> model(createModel(count));
+    const int overrides = 1000;
+
+    QBENCHMARK {
+        for (int i = 0; i < overrides; ++i) {
+            QModelIndex index = model->index(int(qint64(count) * i / overrides), PlaylistModel::Title);
+            model->setData(index, QString("Renamed %1").arg(i));
+        }
+        for (int i = 0; i < overrides; ++i)
+            model->data(model->index(int(qint64(count) * i / overrides), PlaylistModel::Title));
+    }
+}
+
+void tst_bench_playlist::metadataLookup_data()
+{
+    catalogSizes();
+}
+
+void tst_bench_playlist::metadataLookup()
+{
+    QFETCH(int, records);
+
+    MetadataStore store(MetadataFields, createCatalog(records));
+    QStringList record;
+    bool found = false;
+
+    QBENCHMARK {
+        found = store.find(QString("Title %1").arg(records - 1), &record);
+    }
+
+    QVERIFY(found);
+    QCOMPARE(record.at(1), QString("value %1.1").arg(records - 1));
+}
+
+void tst_bench_playlist::metadataSave_data()
+{
+    catalogSizes();
+}
+
+// Updates a record in the middle, which rewrites the whole catalog.
+void tst_bench_playlist::metadataSave()
+{
+    QFETCH(int, records);
+
+    MetadataStore store(MetadataFields, createCatalog(records));
+    QStringList record = createRecord(records / 2);
+    record[1] = "edited";
+
+    QBENCHMARK {
+        QVERIFY(store.save(record));
+    }
+
+    QCOMPARE(store.records().count(), records);
+}
+
+void tst_bench_playlist::metadataExport_data()
+{
+    catalogSizes();
+}
+
+void tst_bench_playlist::metadataExport()
+{
+    QFETCH(int, records);
+
+    MetadataStore store(MetadataFields, createCatalog(records));
+    QString htmlFile = m_dir.filePath("Index.html");
+
+    QBENCHMARK {
+        QVERIFY(store.exportHtml(htmlFile));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_bench_playlist)
+
+#include "tst_bench_playlist.moc"
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "frameanalysis.h"
+#include "histogramkernels.h"
+#include "tracer.h"
+#include "videoframeview.h"
+
+#include <QImage>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+template <class T>
+static QVector<qreal> getBufferLevels(const T *buffer, int frames, int channels);
+
+// This function returns the maximum possible sample value for a given audio format
+qreal getPeakValue(const QAudioFormat& format)
+{
+    // Note: Only the most common sample formats are supported
+    if (!format.isValid())
+        return qreal(0);
+
+    if (format.codec() != "audio/pcm")
+        return qreal(0);
+
+    switch (format.sampleType()) {
+    case QAudioFormat::Unknown:
+        break;
+    case QAudioFormat::Float:
+        if (format.sampleSize() != 32) // other sample formats are not supported
+            return qreal(0);
+        return qreal(1.00003);
+    case QAudioFormat::SignedInt:
+        if (format.sampleSize() == 32)
+            return qreal(INT_MAX);
+        if (format.sampleSize() == 16)
+            return qreal(SHRT_MAX);
+        if (format.sampleSize() == 8)
+            return qreal(CHAR_MAX);
+        break;
+    case QAudioFormat::UnSignedInt:
+        if (format.sampleSize() == 32)
+            return qreal(UINT_MAX);
+        if (format.sampleSize() == 16)
+            return qreal(USHRT_MAX);
+        if (format.sampleSize() == 8)
+            return qreal(UCHAR_MAX);
+        break;
+    }
+
+    return qreal(0);
+}
+
+// returns the audio level for each channel
+QVector<qreal> getBufferLevels(const QAudioBuffer& buffer)
+{
+    TRACE_SCOPE("getBufferLevels");
+    QVector<qreal> values;
+
+    if (!buffer.isValid())
+        return values;
+
+    if (!buffer.format().isValid() || buffer.format().byteOrder() != QAudioFormat::LittleEndian)
+        return values;
+
+    if (buffer.format().codec() != "audio/pcm")
+        return values;
+
+    int channelCount = buffer.format().channelCount();
+    values.fill(0, channelCount);
+    qreal peak_value = getPeakValue(buffer.format());
+    if (qFuzzyCompare(peak_value, qreal(0)))
+        return values;
+
+    switch (buffer.format().sampleType()) {
+    case QAudioFormat::Unknown:
+    case QAudioFormat::UnSignedInt:
+        if (buffer.format().sampleSize() == 32)
+            values = getBufferLevels(buffer.constData<quint32>(), buffer.frameCount(), channelCount);
+        if (buffer.format().sampleSize() == 16)
+            values = getBufferLevels(buffer.constData<quint16>(), buffer.frameCount(), channelCount);
+        if (buffer.format().sampleSize() == 8)
+            values = getBufferLevels(buffer.constData<quint8>(), buffer.frameCount(), channelCount);
+        for (int i = 0; i < values.size(); ++i)
+            values[i] = qAbs(values.at(i) - peak_value / 2) / (peak_value / 2);
+        break;
+    case QAudioFormat::Float:
+        if (buffer.format().sampleSize() == 32) {
+            values = getBufferLevels(buffer.constData<float>(), buffer.frameCount(), channelCount);
+            for (int i = 0; i < values.size(); ++i)
+                values[i] /= peak_value;
+        }
+        break;
+    case QAudioFormat::SignedInt:
+        if (buffer.format().sampleSize() == 32)
+            values = getBufferLevels(buffer.constData<qint32>(), buffer.frameCount(), channelCount);
+        if (buffer.format().sampleSize() == 16)
+            values = getBufferLevels(buffer.constData<qint16>(), buffer.frameCount(), channelCount);
+        if (buffer.format().sampleSize() == 8)
+            values = getBufferLevels(buffer.constData<qint8>(), buffer.frameCount(), channelCount);
+        for (int i = 0; i < values.size(); ++i)
+            values[i] /= peak_value;
+        break;
+    }
+
+    return values;
+}
+
+template <class T>
+QVector<qreal> getBufferLevels(const T *buffer, int frames, int channels)
+{
+    QVector<qreal> max_values;
+    max_values.fill(0, channels);
+
+    for (int i = 0; i < frames; ++i) {
+        for (int j = 0; j < channels; ++j) {
+            qreal value = qAbs(qreal(buffer[i * channels + j]));
+            if (value > max_values.at(j))
+                max_values.replace(j, value);
+        }
+    }
+
+    return max_values;
+}
+
+QVector<quint32> computeHistogramCounts(QVideoFrame frame, int levels)
+{
+    if (!levels)
+        return QVector<quint32>();
+
+    TraceScope map("frame map");
+    VideoFrameView view(frame);
+    map.end();
+    if (!view.isValid())
+        return QVector<quint32>(levels);
+
+    const QVector<quint32> counts = computeHistogramCounts(view, levels);
+
+    TRACE_SCOPE("frame unmap");
+    view.release();
+    return counts;
+}
+
+QVector<quint32> computeHistogramCounts(const VideoFrameView &view, int levels)
+{
+    QVector<quint32> counts(levels);
+
+    if (!levels || !view.isValid())
+        return counts;
+
+    TRACE_SCOPE("histogram compute");
+    const VideoFrameView::Component &luma = view.y();
+    QVarLengthArray<quint32, 4 * 256> partials(4 * levels);
+    std::fill(partials.begin(), partials.end(), 0);
+
+    bool counted = view.isYuv();
+    for (int y = 0; counted && y < view.height(); ++y) {
+        // Process the luma samples where they are
+        counted = countHistogramLine(luma.line(y), view.width(), luma.step, luma.bitDepth,
+                                     luma.significantBits, luma.msbAligned, levels, partials.data());
+    }
+
+    if (counted) {
+        mergeHistogramPartials(partials.constData(), levels, counts.data());
+    } else {
+        counts.fill(0);
+        if (view.isRgb()) {
+            // Process RGB data without converting the frame
+            const VideoFrameView::Component &r = view.r();
+            const VideoFrameView::Component &g = view.g();
+            const VideoFrameView::Component &b = view.b();
+            for (int y = 0; y < view.height(); ++y) {
+                const uchar *red = r.line(y);
+                const uchar *green = g.line(y);
+                const uchar *blue = b.line(y);
+                for (int x = 0; x < view.width(); ++x) {
+                    ++counts[(qGray(*red, *green, *blue) * levels) >> 8];
+                    red += r.step;
+                    green += g.step;
+                    blue += b.step;
+                }
+            }
+        } else {
+            for (int y = 0; y < view.height(); ++y) {
+                for (int x = 0; x < view.width(); ++x)
+                    ++counts[(view.luma(x, y) * levels) >> 8];
+            }
+        }
+    }
+
+    return counts;
+}
+
+QVector<qreal> normalizeHistogram(const QVector<quint32> &counts)
+{
+    QVector<qreal> histogram(counts.size());
+
+    // find maximum value
+    quint32 maxValue = 0;
+    for (int i = 0; i < counts.size(); i++) {
+        if (counts[i] > maxValue)
+            maxValue = counts[i];
+    }
+
+    if (maxValue > 0) {
+        for (int i = 0; i < counts.size(); i++)
+            histogram[i] = qreal(counts[i]) / maxValue;
+    }
+
+    return histogram;
+}
+
+QVector<qreal> computeHistogram(QVideoFrame frame, int levels)
+{
+    return normalizeHistogram(computeHistogramCounts(frame, levels));
+}
+
+QVector<quint8> computeLumaGrid(QVideoFrame frame, int columns, int rows)
+{
+    if (columns <= 0 || rows <= 0)
+        return QVector<quint8>();
+
+    TraceScope map("frame map");
+    VideoFrameView view(frame);
+    map.end();
+    return computeLumaGrid(view, columns, rows);
+}
+
+QVector<quint8> computeLumaGrid(const VideoFrameView &view, int columns, int rows)
+{
+    const int samples = 4; // per cell and axis
+    QVector<quint8> grid;
+
+    if (columns <= 0 || rows <= 0 || !view.isValid())
+        return grid;
+
+    TRACE_SCOPE("luma grid");
+    const int width = view.width();
+    const int height = view.height();
+
+    grid.resize(columns * rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            int sum = 0;
+            for (int j = 0; j < samples; ++j) {
+                int y = ((row * samples + j) * 2 + 1) * height / (rows * samples * 2);
+                for (int i = 0; i < samples; ++i) {
+                    int x = ((column * samples + i) * 2 + 1) * width / (columns * samples * 2);
+                    sum += view.luma(x, y);
+                }
+            }
+            grid[row * columns + column] = quint8(sum / (samples * samples));
+        }
+    }
+
+    return grid;
+}
\ No newline at end of file
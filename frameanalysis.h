@@ -0,0 +1,38 @@
+#ifndef FRAMEANALYSIS_H
+#define FRAMEANALYSIS_H
+
+#include <QAudioBuffer>
+#include <QVector>
+#include <QVideoFrame>
+
+class VideoFrameView;
+
+// Analysis kernels shared by the widgets and the headless analyzer.
+
+// Returns the luma sample counts of the frame in the given number of levels,
+// whatever the bit depth of the frame.
+QVector<quint32> computeHistogramCounts(QVideoFrame frame, int levels);
+QVector<quint32> computeHistogramCounts(const VideoFrameView &view, int levels);
+
+// Scales the counts so the largest bin is 1.0.
+QVector<qreal> normalizeHistogram(const QVector<quint32> &counts);
+
+// Returns the luma histogram of the frame with the given number of levels,
+// normalized so the largest bin is 1.0.
+QVector<qreal> computeHistogram(QVideoFrame frame, int levels);
+
+// Returns the mean luma of a columns x rows grid over the frame, row by row.
+// Every cell is sampled at the same number of points, so the cost does not
+// depend on the frame size.
+QVector<quint8> computeLumaGrid(QVideoFrame frame, int columns, int rows);
+// The view variants work on a frame that is already mapped, so several
+// kernels can share one mapping.
+QVector<quint8> computeLumaGrid(const VideoFrameView &view, int columns, int rows);
+
+// This function returns the maximum possible sample value for a given audio format
+qreal getPeakValue(const QAudioFormat &format);
+
+// returns the audio level for each channel
+QVector<qreal> getBufferLevels(const QAudioBuffer &buffer);
+
+#endif // FRAMEANALYSIS_H
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "frameexporter.h"
+#include "perfcounters.h"
+#include "tracer.h"
+#include "videoframeview.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+
+static QString pixelFormatName(QVideoFrame::PixelFormat format)
+{
+    switch (format) {
+    case QVideoFrame::Format_YUV420P:
+        return QStringLiteral("yuv420p");
+    case QVideoFrame::Format_YV12:
+        return QStringLiteral("yv12");
+    case QVideoFrame::Format_NV12:
+        return QStringLiteral("nv12");
+    case QVideoFrame::Format_NV21:
+        return QStringLiteral("nv21");
+    case QVideoFrame::Format_UYVY:
+        return QStringLiteral("uyvy");
+    case QVideoFrame::Format_YUYV:
+        return QStringLiteral("yuyv");
+    case QVideoFrame::Format_RGB32:
+        return QStringLiteral("rgb32");
+    case QVideoFrame::Format_ARGB32:
+        return QStringLiteral("argb32");
+    case QVideoFrame::Format_BGRA32:
+        return QStringLiteral("bgra32");
+    default:
+        return QString("format%1").arg(int(format));
+    }
+}
+
+static int clamp8(int value)
+{
+    return qBound(0, value, 255);
+}
+
+// Formats QImage understands are copied as is; YUV is converted with the
+// BT.601 video range matrix.
+static QImage frameToImage(QVideoFrame &frame)
+{
+    VideoFrameView view(frame);
+    if (!view.isValid())
+        return QImage();
+
+    QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(frame.pixelFormat());
+    if (imageFormat != QImage::Format_Invalid)
+        return QImage(frame.bits(), frame.width(), frame.height(), frame.bytesPerLine(), imageFormat).copy();
+
+    if (!view.isYuv() && !view.isRgb())
+        return QImage();
+
+    QImage image(view.width(), view.height(), QImage::Format_RGB32);
+    for (int y = 0; y < view.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < view.width(); ++x) {
+            if (view.isRgb()) {
+                line[x] = qRgb(view.r().value8(x, y), view.g().value8(x, y), view.b().value8(x, y));
+                continue;
+            }
+            int u = 128;
+            int v = 128;
+            view.chroma(x, y, &u, &v);
+            const int c = 298 * (view.luma(x, y) - 16);
+            const int d = u - 128;
+            const int e = v - 128;
+            line[x] = qRgb(clamp8((c + 409 * e + 128) >> 8),
+                           clamp8((c - 100 * d - 208 * e + 128) >> 8),
+                           clamp8((c + 516 * d + 128) >> 8));
+        }
+    }
+    return image;
+}
+
+void FrameEncoder::encode(QVideoFrame frame, const QString &fileName, int format, int quality)
+{
+    TRACE_SCOPE("FrameEncoder::encode");
+    PerfTimer timer(PerfCounters::FrameEncode);
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    bool ok = false;
+
+    if (format == FrameExporter::Raw) {
+        if (frame.map(QAbstractVideoBuffer::ReadOnly)) {
+            QFile file(fileName);
+            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                ok = file.write(reinterpret_cast<const char *>(frame.bits()), frame.mappedBytes()) == frame.mappedBytes();
+            frame.unmap();
+        }
+    } else {
+        QImage image = frameToImage(frame);
+        if (!image.isNull())
+            ok = format == FrameExporter::Jpeg ? image.save(fileName, "JPG", quality) : image.save(fileName, "PNG");
+    }
+
+    emit frameEncoded(fileName, ok);
+}
+
+FrameExporter::FrameExporter(QObject *parent)
+    : QObject(parent)
+{
+    m_encoder.moveToThread(&m_encoderThread);
+    connect(&m_encoder, &FrameEncoder::frameEncoded, this, &FrameExporter::frameEncoded);
+    m_encoderThread.start(QThread::LowPriority);
+}
+
+FrameExporter::~FrameExporter()
+{
+    m_encoderThread.quit();
+    m_encoderThread.wait();
+}
+
+bool FrameExporter::formatFromName(const QString &name, Format *format)
+{
+    const QString lower = name.toLower();
+    if (lower == QLatin1String("png"))
+        *format = Png;
+    else if (lower == QLatin1String("jpeg") || lower == QLatin1String("jpg"))
+        *format = Jpeg;
+    else if (lower == QLatin1String("raw"))
+        *format = Raw;
+    else
+        return false;
+    return true;
+}
+
+void FrameExporter::setBaseName(const QString &baseName)
+{
+    m_baseName = baseName.isEmpty() ? QStringLiteral("frame") : baseName;
+}
+
+void FrameExporter::grabNext()
+{
+    const bool wasActive = isActive();
+    m_grabPending = true;
+    if (!wasActive)
+        emit activeChanged(true);
+}
+
+// Saves the last probed frame right away, if there is one and a free slot.
+bool FrameExporter::grabLast()
+{
+    if (!m_lastFrame.isValid() || m_pending >= m_maxPending)
+        return false;
+
+    encode(m_lastFrame);
+    return true;
+}
+
+void FrameExporter::startBurst(int interval)
+{
+    const bool wasActive = isActive();
+    m_burstInterval = qMax(1, interval);
+    m_burstCounter = 0;
+    m_dropped = 0;
+    if (!wasActive)
+        emit activeChanged(true);
+}
+
+void FrameExporter::stopBurst()
+{
+    const bool wasActive = isActive();
+    m_burstInterval = 0;
+    if (wasActive && !isActive())
+        emit activeChanged(false);
+}
+
+void FrameExporter::processFrame(const QVideoFrame &frame)
+{
+    if (!frame.isValid())
+        return;
+
+    // A shallow copy: it only keeps one decoded buffer alive.
+    m_lastFrame = frame;
+    if (!isActive())
+        return;
+
+    const bool burstFrame = m_burstInterval > 0 && m_burstCounter++ % m_burstInterval == 0;
+    if (!m_grabPending && !burstFrame)
+        return;
+
+    // A single grab waits for a free slot; burst frames are skipped.
+    if (m_pending >= m_maxPending) {
+        if (burstFrame)
+            ++m_dropped;
+        return;
+    }
+
+    if (m_grabPending) {
+        m_grabPending = false;
+        if (!isActive())
+            emit activeChanged(false);
+    }
+
+    encode(frame);
+}
+
+void FrameExporter::encode(const QVideoFrame &frame)
+{
+    ++m_pending;
+    QMetaObject::invokeMethod(&m_encoder, "encode", Qt::QueuedConnection,
+                              Q_ARG(QVideoFrame, frame), Q_ARG(QString, fileNameFor(frame)),
+                              Q_ARG(int, m_format), Q_ARG(int, m_quality));
+}
+
+void FrameExporter::frameEncoded(const QString &fileName, bool ok)
+{
+    --m_pending;
+    if (ok)
+        emit frameSaved(fileName);
+    else
+        emit frameFailed(fileName);
+}
+
+QString FrameExporter::fileNameFor(const QVideoFrame &frame)
+{
+    QString name = frame.startTime() >= 0
+            ? QString("%1-%2").arg(m_baseName).arg(frame.startTime() / 1000, 9, 10, QChar('0'))
+            : QString("%1-frame%2").arg(m_baseName).arg(m_sequence++, 6, 10, QChar('0'));
+
+    switch (m_format) {
+    case Png:
+        name += QLatin1String(".png");
+        break;
+    case Jpeg:
+        name += QLatin1String(".jpg");
+        break;
+    case Raw:
+        name += QString("-%1x%2-%3.raw").arg(frame.width()).arg(frame.height())
+                .arg(pixelFormatName(frame.pixelFormat()));
+        break;
+    }
+
+    return QDir(m_directory.isEmpty() ? QDir::currentPath() : m_directory).filePath(name);
+}
\ No newline at end of file
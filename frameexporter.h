@@ -0,0 +1,98 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include <QVideoFrame>
+
+class FrameEncoder : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void encode(QVideoFrame frame, const QString &fileName, int format, int quality);
+
+signals:
+    void frameEncoded(const QString &fileName, bool ok);
+};
+
+// Saves probed video frames as PNG, JPEG or the raw mapped frame data.
+//
+// Frames are handed to an encoder thread as shallow copies. At most
+// maxPending() of them are in flight; further frames are dropped rather than
+// queued, so a slow disk neither blocks the GUI thread nor holds on to the
+// decoder's buffers. A single grab saves the next frame, or the last probed
+// one, which is the frame on screen while paused; a burst saves every
+// interval-th frame until it is stopped.
+class FrameExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format
+    {
+        Png,
+        Jpeg,
+        Raw
+    };
+
+    explicit FrameExporter(QObject *parent = nullptr);
+    ~FrameExporter();
+
+    Format format() const { return m_format; }
+    void setFormat(Format format) { m_format = format; }
+    static bool formatFromName(const QString &name, Format *format);
+
+    void setQuality(int quality) { m_quality = quality; }
+
+    int maxPending() const { return m_maxPending; }
+    void setMaxPending(int count) { m_maxPending = qMax(1, count); }
+
+    QString directory() const { return m_directory; }
+    void setDirectory(const QString &directory) { m_directory = directory; }
+    void setBaseName(const QString &baseName);
+
+    bool isActive() const { return m_grabPending || m_burstInterval > 0; }
+    bool isBursting() const { return m_burstInterval > 0; }
+    // Burst frames skipped because the encoder was behind.
+    int droppedFrames() const { return m_dropped; }
+
+    bool hasLastFrame() const { return m_lastFrame.isValid(); }
+    void clearLastFrame() { m_lastFrame = QVideoFrame(); }
+
+public slots:
+    void grabNext();
+    bool grabLast();
+    void startBurst(int interval);
+    void stopBurst();
+    void processFrame(const QVideoFrame &frame);
+
+signals:
+    void activeChanged(bool active);
+    void frameSaved(const QString &fileName);
+    void frameFailed(const QString &fileName);
+
+private:
+    void encode(const QVideoFrame &frame);
+    void frameEncoded(const QString &fileName, bool ok);
+    QString fileNameFor(const QVideoFrame &frame);
+
+    Format m_format = Png;
+    int m_quality = 90;
+    int m_maxPending = 4;
+    QString m_directory;
+    QString m_baseName = QStringLiteral("frame");
+
+    bool m_grabPending = false;
+    int m_burstInterval = 0;
+    int m_burstCounter = 0;
+    int m_pending = 0;
+    int m_dropped = 0;
+    int m_sequence = 0;
+    QVideoFrame m_lastFrame;
+
+    FrameEncoder m_encoder;
+    QThread m_encoderThread;
+};
+
+#endif // FRAMEEXPORTER_H
\ No newline at end of file
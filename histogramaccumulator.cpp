@@ -0,0 +1,98 @@
+#include "histogramaccumulator.h"
+
+template <class T>
+static QVector<qreal> normalized(const QVector<T> &values)
+{
+    QVector<qreal> histogram(values.size());
+
+    T maxValue = 0;
+    for (int i = 0; i < values.size(); ++i) {
+        if (values[i] > maxValue)
+            maxValue = values[i];
+    }
+
+    if (maxValue > 0) {
+        for (int i = 0; i < values.size(); ++i)
+            histogram[i] = qreal(values[i]) / maxValue;
+    }
+    return histogram;
+}
+
+void HistogramAccumulator::setWindowSize(int frames)
+{
+    frames = qMax(1, frames);
+    if (frames == m_windowSize)
+        return;
+
+    m_windowSize = frames;
+    m_ring.clear();
+    m_ringNext = 0;
+    m_windowSum.fill(0);
+}
+
+void HistogramAccumulator::add(const QVector<quint32> &counts)
+{
+    const int levels = counts.size();
+    if (levels != m_last.size()) {
+        reset();
+        m_average.fill(0, levels);
+        m_windowSum.fill(0, levels);
+        m_cumulative.fill(0, levels);
+    }
+
+    quint64 total = 0;
+    for (quint32 count : counts)
+        total += count;
+
+    // the average works on fractions so frames of any size weigh the same
+    if (total) {
+        bool first = m_last.isEmpty();
+        for (int i = 0; i < levels; ++i) {
+            qreal fraction = qreal(counts[i]) / total;
+            m_average[i] = first ? fraction : m_average[i] + m_decay * (fraction - m_average[i]);
+        }
+    }
+
+    // the oldest histogram of a full ring leaves the window
+    if (m_ring.size() < m_windowSize) {
+        m_ring.append(counts);
+    } else {
+        const QVector<quint32> &oldest = m_ring.at(m_ringNext);
+        for (int i = 0; i < levels; ++i)
+            m_windowSum[i] -= oldest[i];
+        m_ring[m_ringNext] = counts;
+        m_ringNext = (m_ringNext + 1) % m_windowSize;
+    }
+
+    for (int i = 0; i < levels; ++i) {
+        m_windowSum[i] += counts[i];
+        m_cumulative[i] += counts[i];
+    }
+
+    m_last = counts;
+}
+
+void HistogramAccumulator::reset()
+{
+    m_last.clear();
+    m_average.fill(0);
+    m_ring.clear();
+    m_ringNext = 0;
+    m_windowSum.fill(0);
+    m_cumulative.fill(0);
+}
+
+QVector<qreal> HistogramAccumulator::histogram() const
+{
+    switch (m_mode) {
+    case Exponential:
+        return normalized(m_average);
+    case Window:
+        return normalized(m_windowSum);
+    case Cumulative:
+        return normalized(m_cumulative);
+    case Instant:
+        break;
+    }
+    return normalized(m_last);
+}
\ No newline at end of file
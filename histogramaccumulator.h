@@ -0,0 +1,48 @@
+#ifndef HISTOGRAMACCUMULATOR_H
+#define HISTOGRAMACCUMULATOR_H
+
+#include <QVector>
+
+// Keeps smoothed and accumulated views of a stream of histograms.
+//
+// Every frame updates all of them in O(levels): an exponential moving
+// average, the sum over the last N frames (a ring of integer histograms plus
+// their running total) and the sum over the whole clip. The selected mode
+// decides which one histogram() returns.
+class HistogramAccumulator
+{
+public:
+    enum Mode
+    {
+        Instant,
+        Exponential,
+        Window,
+        Cumulative
+    };
+
+    Mode mode() const { return m_mode; }
+    void setMode(Mode mode) { m_mode = mode; }
+
+    void setDecay(qreal alpha) { m_decay = alpha; }
+    void setWindowSize(int frames);
+
+    void add(const QVector<quint32> &counts);
+    void reset();
+
+    // The histogram of the current mode, normalized so the largest bin is 1.0.
+    QVector<qreal> histogram() const;
+
+private:
+    Mode m_mode = Instant;
+    qreal m_decay = 0.1;
+    int m_windowSize = 50;
+
+    QVector<quint32> m_last;
+    QVector<qreal> m_average;
+    QVector<QVector<quint32>> m_ring;
+    int m_ringNext = 0;
+    QVector<quint64> m_windowSum;
+    QVector<quint64> m_cumulative;
+};
+
+#endif // HISTOGRAMACCUMULATOR_H
\ No newline at end of file
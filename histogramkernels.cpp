@@ -0,0 +1,110 @@
+#include "histogramkernels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSE2__)
+// Bins of 16 samples at a time; the counter updates stay scalar since SSE2
+// has no scatter.
+template <int Bits, bool Msb>
+static int countHistogramSse2(const uchar *data, int count, int levels, quint32 *partials)
+{
+    quint32 *partial[4] = { partials, partials + levels, partials + 2 * levels, partials + 3 * levels };
+    alignas(16) quint16 bins[16];
+    int i = 0;
+
+    if (Bits == 8) {
+        // v * levels fits in 16 bits for levels <= 256
+        if (levels > 256)
+            return 0;
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i factor = _mm_set1_epi16(short(levels));
+        for (; i + 16 <= count; i += 16) {
+            __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(samples, zero), factor);
+            __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(samples, zero), factor);
+            _mm_store_si128(reinterpret_cast<__m128i *>(bins), _mm_srli_epi16(low, 8));
+            _mm_store_si128(reinterpret_cast<__m128i *>(bins + 8), _mm_srli_epi16(high, 8));
+            for (int j = 0; j < 16; ++j)
+                ++partial[j & 3][bins[j]];
+        }
+    } else {
+        // Scale to the full 16 bits, then the bin is the high half of v * levels.
+        if (levels > 0xffff)
+            return 0;
+
+        const __m128i factor = _mm_set1_epi16(short(levels));
+        const __m128i mask = _mm_set1_epi16(short(Msb ? 0xffff << (16 - Bits) : (1 << Bits) - 1));
+        for (; i + 16 <= count; i += 16) {
+            for (int half = 0; half < 2; ++half) {
+                __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + (i + half * 8) * 2));
+                samples = _mm_and_si128(samples, mask);
+                if (!Msb)
+                    samples = _mm_slli_epi16(samples, 16 - Bits);
+                _mm_store_si128(reinterpret_cast<__m128i *>(bins + half * 8), _mm_mulhi_epu16(samples, factor));
+            }
+            for (int j = 0; j < 16; ++j)
+                ++partial[j & 3][bins[j]];
+        }
+    }
+
+    return i;
+}
+#endif
+
+template <int Bits, bool Msb>
+void countHistogramLine(const uchar *data, int count, int step, int levels, quint32 *partials)
+{
+    int done = 0;
+#if defined(__SSE2__)
+    if (step == (Bits == 8 ? 1 : 2))
+        done = countHistogramSse2<Bits, Msb>(data, count, levels, partials);
+#endif
+    countHistogramScalar<Bits, Msb>(data + done * step, count - done, step, levels, partials);
+}
+
+template void countHistogramLine<8, false>(const uchar *, int, int, int, quint32 *);
+template void countHistogramLine<10, false>(const uchar *, int, int, int, quint32 *);
+template void countHistogramLine<10, true>(const uchar *, int, int, int, quint32 *);
+template void countHistogramLine<12, false>(const uchar *, int, int, int, quint32 *);
+template void countHistogramLine<12, true>(const uchar *, int, int, int, quint32 *);
+template void countHistogramLine<16, false>(const uchar *, int, int, int, quint32 *);
+
+void mergeHistogramPartials(const quint32 *partials, int levels, quint32 *counts)
+{
+    for (int i = 0; i < levels; ++i)
+        counts[i] += partials[i] + partials[levels + i] + partials[2 * levels + i] + partials[3 * levels + i];
+}
+
+bool countHistogramLine(const uchar *data, int count, int step, int storageBits, int significantBits,
+                        bool msbAligned, int levels, quint32 *partials)
+{
+    if (storageBits == 8 && significantBits == 8) {
+        countHistogramLine<8, false>(data, count, step, levels, partials);
+        return true;
+    }
+    if (storageBits != 16)
+        return false;
+
+    switch (significantBits) {
+    case 10:
+        if (msbAligned)
+            countHistogramLine<10, true>(data, count, step, levels, partials);
+        else
+            countHistogramLine<10, false>(data, count, step, levels, partials);
+        return true;
+    case 12:
+        if (msbAligned)
+            countHistogramLine<12, true>(data, count, step, levels, partials);
+        else
+            countHistogramLine<12, false>(data, count, step, levels, partials);
+        return true;
+    case 16:
+        countHistogramLine<16, false>(data, count, step, levels, partials);
+        return true;
+    default:
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef HISTOGRAMKERNELS_H
+#define HISTOGRAMKERNELS_H
+
+#include <QtGlobal>
+
+// Integer luma histogram kernels for 8 to 16 bit samples.
+//
+// A sample of Bits significant bits lands in bin (value * levels) >> Bits,
+// so the bins mean the same whatever the input depth. Samples wider than 8
+// bits are little-endian 16 bit words holding the value either in the low
+// bits (Msb = false, e.g. YUV420P10) or in the high bits (Msb = true, e.g.
+// P010). Counts are spread over four partial histograms so that runs of the
+// same bin do not serialize on one counter; they are summed at the end.
+//
+// counts must hold levels entries and is added to, not cleared.
+
+template <int Bits, bool Msb>
+inline int histogramBin(quint32 sample, int levels)
+{
+    if (Bits == 8)
+        return int((sample * quint32(levels)) >> 8);
+
+    quint32 value = Msb ? sample >> (16 - Bits) : sample & ((1u << Bits) - 1);
+    return int((value * quint32(levels)) >> Bits);
+}
+
+template <int Bits, bool Msb>
+void countHistogramScalar(const uchar *data, int count, int step, int levels, quint32 *partials)
+{
+    quint32 *partial[4] = { partials, partials + levels, partials + 2 * levels, partials + 3 * levels };
+
+    if (Bits == 8) {
+        for (int i = 0; i < count; ++i, data += step)
+            ++partial[i & 3][histogramBin<Bits, Msb>(*data, levels)];
+    } else {
+        for (int i = 0; i < count; ++i, data += step)
+            ++partial[i & 3][histogramBin<Bits, Msb>(data[0] | (data[1] << 8), levels)];
+    }
+}
+
+// Counts one line of count samples that are step bytes apart into four
+// partial histograms of levels bins each (partials holds 4 * levels).
+// Contiguous lines take the SSE2 path where available.
+template <int Bits, bool Msb>
+void countHistogramLine(const uchar *data, int count, int step, int levels, quint32 *partials);
+
+// Sums the partial histograms into counts.
+void mergeHistogramPartials(const quint32 *partials, int levels, quint32 *counts);
+
+// Picks the kernel for the sample layout; returns false if there is none.
+bool countHistogramLine(const uchar *data, int count, int step, int storageBits, int significantBits,
+                        bool msbAligned, int levels, quint32 *partials);
+
+#endif // HISTOGRAMKERNELS_H
\ No newline at end of file
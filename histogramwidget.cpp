@@ -1,9 +1,13 @@
 #include "histogramwidget.h"
+#include "analysisexecutor.h"
+#include "analysispresenter.h"
+#include "frameanalysis.h"
+#include "perfcounters.h"
+#include "tracer.h"
+#include "videoframeview.h"
 #include <QPainter>
 #include <QHBoxLayout>
-
-template <class T>
-static QVector<qreal> getBufferLevels(const T *buffer, int frames, int channels);
+#include <QTimer>
 
 class QAudioLevel : public QWidget
 {
@@ -12,7 +16,7 @@ public:
     explicit QAudioLevel(QWidget *parent = nullptr);
 
     // Using [0; 1.0] range
-    void setLevel(qreal level);
+    void setLevel(qreal level, bool repaint = true);
 
 protected:
     void paintEvent(QPaintEvent *event);
@@ -28,11 +32,12 @@ QAudioLevel::QAudioLevel(QWidget *parent)
     setMaximumHeight(50);
 }
 
-void QAudioLevel::setLevel(qreal level)
+void QAudioLevel::setLevel(qreal level, bool repaint)
 {
     if (m_level != level) {
         m_level = level;
-        update();
+        if (repaint)
+            update();
     }
 }
 
@@ -51,140 +56,78 @@ void QAudioLevel::paintEvent(QPaintEvent *event)
 HistogramWidget::HistogramWidget(QWidget *parent)
     : QWidget(parent)
 {
-    m_processor.moveToThread(&m_processorThread);
     qRegisterMetaType<QVector<qreal>>("QVector<qreal>");
+    qRegisterMetaType<QVector<quint32>>("QVector<quint32>");
+    qRegisterMetaType<SceneEvent>("SceneEvent");
     connect(&m_processor, &FrameProcessor::histogramReady, this, &HistogramWidget::setHistogram);
-    m_processorThread.start(QThread::LowestPriority);
+    connect(&m_processor, &FrameProcessor::frameAnalyzed, this, &HistogramWidget::frameAnalyzed);
+    connect(&m_processor, &FrameProcessor::sceneEvent, this, &HistogramWidget::sceneEvent);
     setLayout(new QHBoxLayout);
 }
 
 HistogramWidget::~HistogramWidget()
 {
-    m_processorThread.quit();
-    m_processorThread.wait(10000);
+    AnalysisExecutor::instance()->cancel(&m_processor);
 }
 
-void HistogramWidget::processFrame(const QVideoFrame &frame)
+void HistogramWidget::setRepaintTimer(QTimer *timer)
 {
-    if (m_isBusy && frame.isValid())
-        return; //drop frame
+    if (m_repaintTimer)
+        disconnect(m_repaintTimer, nullptr, this, nullptr);
 
-    m_isBusy = true;
-    QMetaObject::invokeMethod(&m_processor, "processFrame",
-                              Qt::QueuedConnection, Q_ARG(QVideoFrame, frame), Q_ARG(int, m_levels));
+    m_repaintTimer = timer;
+    if (m_repaintTimer)
+        connect(m_repaintTimer, &QTimer::timeout, this, &HistogramWidget::repaintIfDirty);
 }
 
-// This function returns the maximum possible sample value for a given audio format
-qreal getPeakValue(const QAudioFormat& format)
+void HistogramWidget::repaintIfDirty()
 {
-    // Note: Only the most common sample formats are supported
-    if (!format.isValid())
-        return qreal(0);
-
-    if (format.codec() != "audio/pcm")
-        return qreal(0);
-
-    switch (format.sampleType()) {
-    case QAudioFormat::Unknown:
-        break;
-    case QAudioFormat::Float:
-        if (format.sampleSize() != 32) // other sample formats are not supported
-            return qreal(0);
-        return qreal(1.00003);
-    case QAudioFormat::SignedInt:
-        if (format.sampleSize() == 32)
-            return qreal(INT_MAX);
-        if (format.sampleSize() == 16)
-            return qreal(SHRT_MAX);
-        if (format.sampleSize() == 8)
-            return qreal(CHAR_MAX);
-        break;
-    case QAudioFormat::UnSignedInt:
-        if (format.sampleSize() == 32)
-            return qreal(UINT_MAX);
-        if (format.sampleSize() == 16)
-            return qreal(USHRT_MAX);
-        if (format.sampleSize() == 8)
-            return qreal(UCHAR_MAX);
-        break;
-    }
+    if (!m_dirty)
+        return;
 
-    return qreal(0);
+    m_dirty = false;
+    update();
+    for (QAudioLevel *level : qAsConst(m_audioLevels))
+        level->update();
 }
 
-// returns the audio level for each channel
-QVector<qreal> getBufferLevels(const QAudioBuffer& buffer)
+void HistogramWidget::setAccumulation(HistogramAccumulator::Mode mode, int windowSize)
 {
-    QVector<qreal> values;
-
-    if (!buffer.isValid())
-        return values;
-
-    if (!buffer.format().isValid() || buffer.format().byteOrder() != QAudioFormat::LittleEndian)
-        return values;
-
-    if (buffer.format().codec() != "audio/pcm")
-        return values;
-
-    int channelCount = buffer.format().channelCount();
-    values.fill(0, channelCount);
-    qreal peak_value = getPeakValue(buffer.format());
-    if (qFuzzyCompare(peak_value, qreal(0)))
-        return values;
-
-    switch (buffer.format().sampleType()) {
-    case QAudioFormat::Unknown:
-    case QAudioFormat::UnSignedInt:
-        if (buffer.format().sampleSize() == 32)
-            values = getBufferLevels(buffer.constData<quint32>(), buffer.frameCount(), channelCount);
-        if (buffer.format().sampleSize() == 16)
-            values = getBufferLevels(buffer.constData<quint16>(), buffer.frameCount(), channelCount);
-        if (buffer.format().sampleSize() == 8)
-            values = getBufferLevels(buffer.constData<quint8>(), buffer.frameCount(), channelCount);
-        for (int i = 0; i < values.size(); ++i)
-            values[i] = qAbs(values.at(i) - peak_value / 2) / (peak_value / 2);
-        break;
-    case QAudioFormat::Float:
-        if (buffer.format().sampleSize() == 32) {
-            values = getBufferLevels(buffer.constData<float>(), buffer.frameCount(), channelCount);
-            for (int i = 0; i < values.size(); ++i)
-                values[i] /= peak_value;
-        }
-        break;
-    case QAudioFormat::SignedInt:
-        if (buffer.format().sampleSize() == 32)
-            values = getBufferLevels(buffer.constData<qint32>(), buffer.frameCount(), channelCount);
-        if (buffer.format().sampleSize() == 16)
-            values = getBufferLevels(buffer.constData<qint16>(), buffer.frameCount(), channelCount);
-        if (buffer.format().sampleSize() == 8)
-            values = getBufferLevels(buffer.constData<qint8>(), buffer.frameCount(), channelCount);
-        for (int i = 0; i < values.size(); ++i)
-            values[i] /= peak_value;
-        break;
-    }
-
-    return values;
+    FrameProcessor *processor = &m_processor;
+    AnalysisExecutor::instance()->submit(processor, [processor, mode, windowSize]() {
+        processor->setAccumulation(mode, windowSize);
+    });
 }
 
-template <class T>
-QVector<qreal> getBufferLevels(const T *buffer, int frames, int channels)
+void HistogramWidget::processFrame(const QVideoFrame &frame)
 {
-    QVector<qreal> max_values;
-    max_values.fill(0, channels);
-
-    for (int i = 0; i < frames; ++i) {
-        for (int j = 0; j < channels; ++j) {
-            qreal value = qAbs(qreal(buffer[i * channels + j]));
-            if (value > max_values.at(j))
-                max_values.replace(j, value);
-        }
+    if (!m_liveAnalysis && frame.isValid())
+        return;
+
+    TRACE_SCOPE("frame probe");
+    PerfCounters::increment(PerfCounters::FramesProbed);
+
+    const qint64 now = PerfCounters::now();
+    if (frame.isValid() && (m_isBusy || (m_frameInterval && now - m_probeTime < m_frameInterval))) {
+        PerfCounters::increment(PerfCounters::FramesDropped);
+        return; //drop frame
     }
 
-    return max_values;
+    m_isBusy = true;
+    m_probeTime = now;
+
+    FrameProcessor *processor = &m_processor;
+    const int levels = m_levels;
+    AnalysisExecutor::instance()->submit(processor, [processor, frame, levels]() {
+        processor->processFrame(frame, levels);
+    });
 }
 
 void HistogramWidget::processBuffer(const QAudioBuffer &buffer)
 {
+    if (!m_liveAnalysis && buffer.isValid())
+        return;
+
     if (m_audioLevels.count() != buffer.format().channelCount()) {
         qDeleteAll(m_audioLevels);
         m_audioLevels.clear();
@@ -195,16 +138,50 @@ void HistogramWidget::processBuffer(const QAudioBuffer &buffer)
         }
     }
 
-    QVector<qreal> levels = getBufferLevels(buffer);
-    for (int i = 0; i < levels.count(); ++i)
-        m_audioLevels.at(i)->setLevel(levels.at(i));
+    PerfCounters::increment(PerfCounters::AudioBuffers);
+    AnalysisExecutor::instance()->submit(&m_processor, [this, buffer]() {
+        QVector<qreal> levels;
+        {
+            PerfTimer timer(PerfCounters::AudioLevels);
+            levels = getBufferLevels(buffer);
+        }
+        const qint64 startTime = buffer.startTime();
+        QMetaObject::invokeMethod(this, [this, startTime, levels]() {
+            setBufferLevels(startTime, levels);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HistogramWidget::setBufferLevels(qint64 startTime, const QVector<qreal> &levels)
+{
+    if (!levels.isEmpty())
+        emit levelsReady(startTime, levels);
+
+    if (m_presenter && !m_presenter->isCurrent(startTime))
+        return;
+
+    // Levels computed before a channel count change are shown as far as they fit.
+    const int count = qMin(levels.count(), m_audioLevels.count());
+    for (int i = 0; i < count; ++i)
+        m_audioLevels.at(i)->setLevel(levels.at(i), !m_repaintTimer);
+    if (m_repaintTimer)
+        m_dirty = true;
 }
 
-void HistogramWidget::setHistogram(const QVector<qreal> &histogram)
+void HistogramWidget::setHistogram(qint64 startTime, const QVector<qreal> &histogram)
 {
+    if (m_isBusy)
+        PerfCounters::addSample(PerfCounters::ProbeToHistogram, PerfCounters::now() - m_probeTime);
     m_isBusy = false;
+
+    if (m_presenter && !m_presenter->isCurrent(startTime))
+        return;
+
     m_histogram = histogram;
-    update();
+    if (m_repaintTimer)
+        m_dirty = true;
+    else
+        update();
 }
 
 void HistogramWidget::paintEvent(QPaintEvent *event)
@@ -214,6 +191,8 @@ void HistogramWidget::paintEvent(QPaintEvent *event)
     if (!m_audioLevels.isEmpty())
         return;
 
+    TRACE_SCOPE("HistogramWidget::paintEvent");
+    PerfTimer timer(PerfCounters::HistogramPaint);
     QPainter painter(this);
 
     if (m_histogram.isEmpty()) {
@@ -232,60 +211,51 @@ void HistogramWidget::paintEvent(QPaintEvent *event)
     }
 }
 
+void FrameProcessor::setAccumulation(int mode, int windowSize)
+{
+    m_accumulator.setMode(HistogramAccumulator::Mode(mode));
+    m_accumulator.setWindowSize(windowSize);
+}
+
 void FrameProcessor::processFrame(QVideoFrame frame, int levels)
 {
-    QVector<qreal> histogram(levels);
-
-    do {
-        if (!levels)
-            break;
-
-        if (!frame.map(QAbstractVideoBuffer::ReadOnly))
-            break;
-
-        if (frame.pixelFormat() == QVideoFrame::Format_YUV420P ||
-            frame.pixelFormat() == QVideoFrame::Format_NV12) {
-            // Process YUV data
-            uchar *b = frame.bits();
-            for (int y = 0; y < frame.height(); ++y) {
-                uchar *lastPixel = b + frame.width();
-                for (uchar *curPixel = b; curPixel < lastPixel; curPixel++)
-                    histogram[(*curPixel * levels) >> 8] += 1.0;
-                b += frame.bytesPerLine();
-            }
-        } else {
-            QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(frame.pixelFormat());
-            if (imageFormat != QImage::Format_Invalid) {
-                // Process RGB data
-                QImage image(frame.bits(), frame.width(), frame.height(), imageFormat);
-                image = image.convertToFormat(QImage::Format_RGB32);
-
-                const QRgb* b = (const QRgb*)image.bits();
-                for (int y = 0; y < image.height(); ++y) {
-                    const QRgb *lastPixel = b + frame.width();
-                    for (const QRgb *curPixel = b; curPixel < lastPixel; curPixel++)
-                        histogram[(qGray(*curPixel) * levels) >> 8] += 1.0;
-                    b = (const QRgb*)((uchar*)b + image.bytesPerLine());
-                }
-            }
+    QVector<quint32> counts(levels);
+    QVector<quint8> grid;
+    {
+        TRACE_SCOPE("FrameProcessor::processFrame");
+        PerfTimer timer(PerfCounters::HistogramCompute);
+        TraceScope map("frame map");
+        VideoFrameView view(frame);
+        map.end();
+        if (view.isValid()) {
+            counts = computeHistogramCounts(view, levels);
+            // The scene analysis grid shares the mapping.
+            grid = computeLumaGrid(view, 32, 18);
         }
+        TRACE_SCOPE("frame unmap");
+        view.release();
+    }
 
-        // find maximum value
-        qreal maxValue = 0.0;
-        for (int i = 0; i < histogram.size(); i++) {
-            if (histogram[i] > maxValue)
-                maxValue = histogram[i];
-        }
+    // An invalid frame marks a media change.
+    if (!frame.isValid()) {
+        m_accumulator.reset();
+        m_sceneAnalyzer.reset();
+        emit histogramReady(-1, QVector<qreal>(levels));
+        return;
+    }
 
-        if (maxValue > 0.0) {
-            for (int i = 0; i < histogram.size(); i++)
-                histogram[i] /= maxValue;
-        }
+    m_accumulator.add(counts);
+    emit histogramReady(frame.startTime(), m_accumulator.histogram());
+    emit frameAnalyzed(frame.startTime(), counts);
 
-        frame.unmap();
-    } while (false);
+    // scene cuts compare single frames, not the accumulated view
+    QVector<qreal> histogram(counts.size());
+    for (int i = 0; i < counts.size(); ++i)
+        histogram[i] = counts[i];
 
-    emit histogramReady(histogram);
+    const QVector<SceneEvent> events = m_sceneAnalyzer.process(frame.startTime(), histogram, grid);
+    for (const SceneEvent &event : events)
+        emit sceneEvent(event);
 }
 
 #include "histogramwidget.moc"
\ No newline at end of file
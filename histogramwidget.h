@@ -1,22 +1,34 @@
 #ifndef HISTOGRAMWIDGET_H
 #define HISTOGRAMWIDGET_H
 
-#include <QThread>
+#include "histogramaccumulator.h"
+#include "sceneanalyzer.h"
+
 #include <QVideoFrame>
 #include <QAudioBuffer>
 #include <QWidget>
 
+class AnalysisPresenter;
 class QAudioLevel;
+class QTimer;
 
+// Runs on the analysis executor, one call at a time.
 class FrameProcessor: public QObject
 {
     Q_OBJECT
 
-public slots:
+public:
     void processFrame(QVideoFrame frame, int levels);
+    void setAccumulation(int mode, int windowSize);
 
 signals:
-    void histogramReady(const QVector<qreal> &histogram);
+    void histogramReady(qint64 startTime, const QVector<qreal> &histogram);
+    void frameAnalyzed(qint64 startTime, const QVector<quint32> &counts);
+    void sceneEvent(const SceneEvent &event);
+
+private:
+    HistogramAccumulator m_accumulator;
+    SceneAnalyzer m_sceneAnalyzer;
 };
 
 class HistogramWidget : public QWidget
@@ -27,21 +39,46 @@ public:
     explicit HistogramWidget(QWidget *parent = nullptr);
     ~HistogramWidget();
     void setLevels(int levels) { m_levels = levels; }
+    void setAccumulation(HistogramAccumulator::Mode mode, int windowSize = 50);
+
+    // Frames arriving sooner than this after the last analyzed one are dropped.
+    void setFrameInterval(int msecs) { m_frameInterval = qint64(msecs) * 1000000; }
+    // Repaints on the timer's ticks instead of on every result.
+    void setRepaintTimer(QTimer *timer);
+    // Drops results the presenter considers stale.
+    void setPresenter(AnalysisPresenter *presenter) { m_presenter = presenter; }
+    // Without live analysis probed frames and buffers are ignored; invalid
+    // ones still reset the display.
+    bool liveAnalysis() const { return m_liveAnalysis; }
+    void setLiveAnalysis(bool enabled) { m_liveAnalysis = enabled; }
 
 public slots:
     void processFrame(const QVideoFrame &frame);
     void processBuffer(const QAudioBuffer &buffer);
-    void setHistogram(const QVector<qreal> &histogram);
+    void setHistogram(qint64 startTime, const QVector<qreal> &histogram);
+
+signals:
+    void frameAnalyzed(qint64 startTime, const QVector<quint32> &counts);
+    void levelsReady(qint64 startTime, const QVector<qreal> &levels);
+    void sceneEvent(const SceneEvent &event);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
 
 private:
+    void repaintIfDirty();
+    void setBufferLevels(qint64 startTime, const QVector<qreal> &levels);
+
     QVector<qreal> m_histogram;
     int m_levels = 128;
     FrameProcessor m_processor;
-    QThread m_processorThread;
+    QTimer *m_repaintTimer = nullptr;
+    AnalysisPresenter *m_presenter = nullptr;
+    bool m_liveAnalysis = true;
     bool m_isBusy = false;
+    bool m_dirty = false;
+    qint64 m_probeTime = 0;
+    qint64 m_frameInterval = 0;
     QVector<QAudioLevel *> m_audioLevels;
 };
 
@@ -1,13 +1,74 @@
 #include "player.h"
+#include "analysisexecutor.h"
+#include "analysisjob.h"
+#include "analysiswriter.h"
+#include "batchscheduler.h"
+#include "monitorwall.h"
+#include "perfcounters.h"
+#include "tracer.h"
 
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 #include <QDir>
+#include <QGuiApplication>
+#include <QScopedPointer>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+
+#include <functional>
+
+static bool hasOption(int argc, char *argv[], const char *option)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!qstrcmp(argv[i], option))
+            return true;
+    }
+    return false;
+}
+
+// Analyzes the urls one after another into a single output stream.
+static int runHeadless(const QList<QUrl> &urls, AnalysisWriter *writer, qreal rate, int levels)
+{
+    int next = 0;
+    int failures = 0;
+
+    std::function<void()> startNext = [&]() {
+        if (next == urls.size()) {
+            QCoreApplication::exit(failures ? 1 : 0);
+            return;
+        }
+
+        AnalysisJob *job = new AnalysisJob(urls.at(next++), writer);
+        job->setLevels(levels);
+        job->setPlaybackRate(rate);
+        QObject::connect(job, &AnalysisJob::finished, [&, job](bool ok) {
+            if (!ok) {
+                ++failures;
+                qWarning().noquote() << job->url().toString() << job->errorString();
+            }
+            job->deleteLater();
+            startNext();
+        });
+        job->start();
+    };
+
+    QTimer::singleShot(0, startNext);
+    return QCoreApplication::exec();
+}
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    // Headless runs must not need a display, so pick the platform before
+    // the application object exists.
+    const bool headless = hasOption(argc, argv, "--headless");
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QScopedPointer<QCoreApplication> app(headless
+            ? new QGuiApplication(argc, argv)
+            : new QApplication(argc, argv));
 
     QCoreApplication::setApplicationName("Player Example");
     QCoreApplication::setOrganizationName("QtProject");
@@ -16,25 +77,229 @@ int main(int argc, char *argv[])
     QCommandLineOption customAudioRoleOption("custom-audio-role",
                                              "Set a custom audio role for the player.",
                                              "role");
+    QCommandLineOption sessionOption("session",
+                                     "Restore and save the playlist and playback state in <file>.",
+                                     "file",
+                                     QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                         + "/session.qvps");
+    QCommandLineOption noSessionOption("no-session",
+                                       "Do not restore or save the playback session.");
+    QCommandLineOption preloadOption("preload",
+                                     "Open the next playlist item <seconds> before the current one ends.",
+                                     "seconds");
+    QCommandLineOption notifyIntervalOption("notify-interval",
+                                            "Update the playback position every <ms> milliseconds.",
+                                            "ms");
+    QCommandLineOption headlessOption("headless",
+                                      "Analyze the URL(s) without a window and write per-frame statistics.");
+    QCommandLineOption outputOption("output",
+                                    "Write headless statistics to <file> (- for stdout).",
+                                    "file", "-");
+    QCommandLineOption formatOption("format",
+                                    "Headless output format: csv or binary.",
+                                    "format", "csv");
+    QCommandLineOption rateOption("rate",
+                                  "Playback rate used for headless analysis.",
+                                  "rate", "4");
+    QCommandLineOption levelsOption("levels",
+                                    "Number of histogram levels in headless analysis.",
+                                    "levels", "128");
+    QCommandLineOption perfLogOption("perf-log",
+                                     "Append performance counters to <file> every few seconds.",
+                                     "file");
+    QCommandLineOption traceOption("trace",
+                                   "Record trace events and write them to <file> (Chrome trace JSON) on exit.",
+                                   "file");
+    QCommandLineOption sceneLogOption("scene-log",
+                                      "Append detected scene cuts, black and frozen frames to <file>.",
+                                      "file");
+    QCommandLineOption outputDirOption("output-dir",
+                                       "Analyze in parallel, writing one statistics file per URL into <dir>.",
+                                       "dir");
+    QCommandLineOption jobsOption("jobs",
+                                  "Number of media analyzed at the same time with --output-dir.",
+                                  "count", QString::number(qMax(1, QThread::idealThreadCount() / 2)));
+    QCommandLineOption jobTimeoutOption("job-timeout",
+                                        "Abort the analysis of a URL after <seconds> (0 for no limit).",
+                                        "seconds", "0");
+    QCommandLineOption manifestOption("manifest",
+                                      "Record finished URLs in <file> and skip them when run again.",
+                                      "file");
+    QCommandLineOption cachedAnalysisOption("cached-analysis",
+                                            "Skip live histogram and level analysis of media with a complete analysis cache. Scene detection and --scene-log pause with it.");
+    QCommandLineOption overviewScanRateOption("overview-scan-rate",
+                                              "Playback rate of the background scan filling the overview (0 disables it).",
+                                              "rate", "8");
+    QCommandLineOption keepPitchOption("keep-pitch",
+                                       "Time-stretch the audio to keep its pitch at playback rates other than 1x.");
+    QCommandLineOption wallOption("wall",
+                                  "Play and monitor all URLs at once in a grid.");
+    QCommandLineOption wallColumnsOption("wall-columns",
+                                         "Number of columns of the wall (0 for a square grid).",
+                                         "count", "0");
+    QCommandLineOption wallFpsOption("wall-fps",
+                                     "Frames analyzed per second and wall tile (0 for all).",
+                                     "fps", "5");
+    QCommandLineOption maxLatencyOption("max-latency",
+                                        "Drop histogram, level and scope results trailing playback by more than <ms> (0 shows all).",
+                                        "ms", "250");
+    QCommandLineOption snapshotDirOption("snapshot-dir",
+                                         "Save snapshots and burst frames to <directory>.",
+                                         "directory");
+    QCommandLineOption snapshotFormatOption("snapshot-format",
+                                            "Snapshot file format: png, jpeg or raw.",
+                                            "format", "png");
+    QCommandLineOption burstIntervalOption("burst-interval",
+                                           "Save one frame in <n> during a burst capture (Shift+S).",
+                                           "n", "10");
+    QCommandLineOption burstOption("burst",
+                                   "Start a burst capture right away.");
+    QCommandLineOption analysisThreadsOption("analysis-threads",
+                                             "Run the histogram, level and scope analysis on at most <count> threads.",
+                                             "count");
     parser.setApplicationDescription("Qt MultiMedia Player Example");
     parser.addHelpOption();
     parser.addVersionOption();
     parser.addOption(customAudioRoleOption);
+    parser.addOption(sessionOption);
+    parser.addOption(noSessionOption);
+    parser.addOption(preloadOption);
+    parser.addOption(notifyIntervalOption);
+    parser.addOption(headlessOption);
+    parser.addOption(outputOption);
+    parser.addOption(formatOption);
+    parser.addOption(rateOption);
+    parser.addOption(levelsOption);
+    parser.addOption(perfLogOption);
+    parser.addOption(traceOption);
+    parser.addOption(sceneLogOption);
+    parser.addOption(outputDirOption);
+    parser.addOption(jobsOption);
+    parser.addOption(jobTimeoutOption);
+    parser.addOption(manifestOption);
+    parser.addOption(cachedAnalysisOption);
+    parser.addOption(overviewScanRateOption);
+    parser.addOption(keepPitchOption);
+    parser.addOption(wallOption);
+    parser.addOption(wallColumnsOption);
+    parser.addOption(wallFpsOption);
+    parser.addOption(analysisThreadsOption);
+    parser.addOption(maxLatencyOption);
+    parser.addOption(snapshotDirOption);
+    parser.addOption(snapshotFormatOption);
+    parser.addOption(burstIntervalOption);
+    parser.addOption(burstOption);
     parser.addPositionalArgument("url", "The URL(s) to open.");
-    parser.process(app);
+    parser.process(*app);
+
+    QList<QUrl> urls;
+    for (auto &a: parser.positionalArguments())
+        urls.append(QUrl::fromUserInput(a, QDir::currentPath(), QUrl::AssumeLocalFile));
+
+    PerfLogger perfLogger;
+    if (parser.isSet(perfLogOption) && !perfLogger.open(parser.value(perfLogOption)))
+        qWarning().noquote() << "Cannot open" << parser.value(perfLogOption);
+
+    if (parser.isSet(traceOption)) {
+        Tracer::setOutputFile(parser.value(traceOption));
+        Tracer::setEnabled(true);
+        QObject::connect(app.data(), &QCoreApplication::aboutToQuit, []() {
+            if (!Tracer::writeChromeTrace(Tracer::outputFile()))
+                qWarning().noquote() << "Cannot write" << Tracer::outputFile();
+        });
+    }
+
+    if (headless) {
+        AnalysisWriter::Format format = parser.value(formatOption) == QLatin1String("binary")
+                ? AnalysisWriter::Binary
+                : AnalysisWriter::Csv;
+
+        if (parser.isSet(outputDirOption)) {
+            BatchScheduler scheduler;
+            scheduler.setOutputDirectory(parser.value(outputDirOption));
+            scheduler.setManifestFile(parser.value(manifestOption));
+            scheduler.setMaxJobs(parser.value(jobsOption).toInt());
+            scheduler.setJobTimeout(parser.value(jobTimeoutOption).toInt() * 1000);
+            scheduler.setFormat(format);
+            scheduler.setPlaybackRate(parser.value(rateOption).toDouble());
+            scheduler.setLevels(parser.value(levelsOption).toInt());
+            QObject::connect(&scheduler, &BatchScheduler::finished, [](int failures) {
+                QCoreApplication::exit(failures ? 1 : 0);
+            });
+            if (!scheduler.start(urls)) {
+                qCritical().noquote() << "Cannot write to" << parser.value(outputDirOption);
+                return 1;
+            }
+            return app->exec();
+        }
+
+        AnalysisWriter writer;
+        if (!writer.open(parser.value(outputOption), format)) {
+            qCritical().noquote() << "Cannot open" << parser.value(outputOption);
+            return 1;
+        }
+        return runHeadless(urls, &writer, parser.value(rateOption).toDouble(),
+                           parser.value(levelsOption).toInt());
+    }
+
+    if (parser.isSet(analysisThreadsOption))
+        AnalysisExecutor::instance()->setMaxThreads(parser.value(analysisThreadsOption).toInt());
+
+    if (parser.isSet(wallOption)) {
+        MonitorWall wall;
+        wall.setColumns(parser.value(wallColumnsOption).toInt());
+        wall.setFrameBudget(parser.value(wallFpsOption).toInt());
+        wall.addFeeds(urls);
+        wall.show();
+        return app->exec();
+    }
 
     Player player;
 
     if (parser.isSet(customAudioRoleOption))
         player.setCustomAudioRole(parser.value(customAudioRoleOption));
 
-    if (!parser.positionalArguments().isEmpty() && player.isPlayerAvailable()) {
-        QList<QUrl> urls;
-        for (auto &a: parser.positionalArguments())
-            urls.append(QUrl::fromUserInput(a, QDir::currentPath(), QUrl::AssumeLocalFile));
+    if (!parser.isSet(noSessionOption))
+        player.setSessionFile(parser.value(sessionOption));
+
+    if (parser.isSet(notifyIntervalOption))
+        player.setNotifyInterval(parser.value(notifyIntervalOption).toInt());
+
+    if (parser.isSet(preloadOption))
+        player.setPreloadInterval(parser.value(preloadOption).toInt());
+
+    if (parser.isSet(sceneLogOption) && !player.setSceneLogFile(parser.value(sceneLogOption)))
+        qWarning().noquote() << "Cannot open" << parser.value(sceneLogOption);
+
+    if (parser.isSet(cachedAnalysisOption))
+        player.setLiveAnalysisWhenCached(false);
+
+    if (parser.isSet(keepPitchOption))
+        player.setPitchCorrection(true);
+
+    if (parser.isSet(maxLatencyOption))
+        player.setMaxResultLatency(parser.value(maxLatencyOption).toInt());
+
+    if (parser.isSet(snapshotDirOption))
+        player.setSnapshotDirectory(parser.value(snapshotDirOption));
+
+    if (parser.isSet(snapshotFormatOption) && !player.setSnapshotFormat(parser.value(snapshotFormatOption)))
+        qWarning().noquote() << "Unknown snapshot format" << parser.value(snapshotFormatOption);
+
+    if (parser.isSet(burstIntervalOption))
+        player.setBurstInterval(parser.value(burstIntervalOption).toInt());
+
+    if (parser.isSet(burstOption))
+        player.startBurst();
+
+    if (parser.isSet(overviewScanRateOption))
+        player.setOverviewScanRate(parser.value(overviewScanRateOption).toDouble());
+
+    if (!urls.isEmpty() && player.isPlayerAvailable())
         player.addToPlaylist(urls);
-    }
+    else if (!parser.isSet(noSessionOption) && player.isPlayerAvailable())
+        player.restoreSession();
 
     player.show();
-    return app.exec();
+    return app->exec();
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "mediafingerprint.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+static const qint64 SampleSize = 64 * 1024;
+
+QString mediaFingerprint(const QUrl &url)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    if (!url.isLocalFile()) {
+        hash.addData(url.toEncoded());
+        return QString::fromLatin1(hash.result().toHex());
+    }
+
+    QFileInfo info(url.toLocalFile());
+    const qint64 size = info.size();
+    hash.addData(QByteArray::number(size));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+
+    QFile file(info.filePath());
+    if (file.open(QIODevice::ReadOnly)) {
+        hash.addData(file.read(SampleSize));
+        if (size > SampleSize && file.seek(qMax(SampleSize, size - SampleSize)))
+            hash.addData(file.read(SampleSize));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
\ No newline at end of file
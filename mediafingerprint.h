@@ -0,0 +1,12 @@
+#ifndef MEDIAFINGERPRINT_H
+#define MEDIAFINGERPRINT_H
+
+#include <QString>
+#include <QUrl>
+
+// Returns a hex key identifying the content of a media file without reading
+// all of it: size, modification time and the first and last blocks of a
+// local file, or the url itself for anything remote.
+QString mediaFingerprint(const QUrl &url);
+
+#endif // MEDIAFINGERPRINT_H
\ No newline at end of file
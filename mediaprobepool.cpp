@@ -0,0 +1,171 @@
+#include "mediaprobepool.h"
+
+#include <QMediaPlayer>
+#include <QThread>
+#include <QTimer>
+
+MediaProbePool::MediaProbePool(QObject *parent)
+    : QObject(parent)
+{
+    m_maxWorkers = qBound(1, QThread::idealThreadCount() / 2, 4);
+}
+
+MediaProbePool::~MediaProbePool()
+{
+    for (Worker *worker : qAsConst(m_workers))
+        disconnect(worker->player, nullptr, this, nullptr);
+    qDeleteAll(m_workers);
+}
+
+void MediaProbePool::setMaxWorkers(int count)
+{
+    m_maxWorkers = qMax(1, count);
+    dispatch();
+}
+
+void MediaProbePool::enqueue(const QList<QUrl> &urls)
+{
+    for (const QUrl &url : urls) {
+        if (url.isEmpty() || m_done.contains(url) || m_running.contains(url) || m_queued.contains(url))
+            continue;
+        m_queue.append(url);
+        m_queued.insert(url);
+    }
+    dispatch();
+}
+
+void MediaProbePool::prioritize(const QList<QUrl> &urls)
+{
+    m_priorityQueue.clear();
+    for (const QUrl &url : urls) {
+        if (!url.isEmpty() && !m_done.contains(url) && !m_running.contains(url))
+            m_priorityQueue.append(url);
+    }
+    dispatch();
+}
+
+void MediaProbePool::clear()
+{
+    m_priorityQueue.clear();
+    m_queue.clear();
+    m_queued.clear();
+    m_done.clear();
+}
+
+void MediaProbePool::dispatch()
+{
+    QUrl url;
+    while (m_workers.size() - m_idle.size() < m_maxWorkers) {
+        if (!takeNext(&url))
+            break;
+
+        Worker *worker = m_idle.isEmpty() ? createWorker() : m_idle.takeLast();
+        startProbe(worker, url);
+    }
+}
+
+bool MediaProbePool::takeNext(QUrl *url)
+{
+    while (!m_priorityQueue.isEmpty()) {
+        QUrl next = m_priorityQueue.takeFirst();
+        if (!m_done.contains(next) && !m_running.contains(next)) {
+            *url = next;
+            return true;
+        }
+    }
+
+    while (!m_queue.isEmpty()) {
+        QUrl next = m_queue.takeFirst();
+        m_queued.remove(next);
+        if (!m_done.contains(next) && !m_running.contains(next)) {
+            *url = next;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+MediaProbePool::Worker *MediaProbePool::createWorker()
+{
+    Worker *worker = new Worker;
+    worker->player = new QMediaPlayer(this);
+    worker->player->setMuted(true);
+    worker->timer = new QTimer(this);
+    worker->timer->setSingleShot(true);
+
+    connect(worker->player, &QMediaPlayer::mediaStatusChanged, this, [this, worker](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::InvalidMedia)
+            finishProbe(worker, false);
+        else
+            checkProbe(worker);
+    });
+    connect(worker->player, &QMediaPlayer::durationChanged, this, [this, worker]() {
+        checkProbe(worker);
+    });
+    connect(worker->player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, [this, worker]() {
+        finishProbe(worker, false);
+    });
+    connect(worker->timer, &QTimer::timeout, this, [this, worker]() {
+        finishProbe(worker, true);
+    });
+
+    m_workers.append(worker);
+    return worker;
+}
+
+void MediaProbePool::startProbe(Worker *worker, const QUrl &url)
+{
+    worker->url = url;
+    m_running.insert(url);
+    worker->timer->start(m_timeout);
+    worker->player->setMedia(QMediaContent(url));
+}
+
+void MediaProbePool::checkProbe(Worker *worker)
+{
+    if (worker->url.isEmpty() || worker->player->duration() <= 0)
+        return;
+
+    switch (worker->player->mediaStatus()) {
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferingMedia:
+    case QMediaPlayer::BufferedMedia:
+        finishProbe(worker, true);
+        break;
+    default:
+        break;
+    }
+}
+
+void MediaProbePool::finishProbe(Worker *worker, bool loaded)
+{
+    if (worker->url.isEmpty())
+        return;
+
+    QUrl url = worker->url;
+    qint64 duration = loaded ? worker->player->duration() : 0;
+    QVariantMap tags;
+    if (loaded) {
+        for (const QString &key : worker->player->availableMetaData())
+            tags.insert(key, worker->player->metaData(key));
+    }
+
+    worker->url.clear();
+    worker->timer->stop();
+    m_running.remove(url);
+    m_done.insert(url);
+    m_idle.append(worker);
+
+    // Release the backend pipeline outside of the signal that got us here.
+    QTimer::singleShot(0, this, [this, worker]() {
+        if (worker->url.isEmpty())
+            worker->player->setMedia(QMediaContent());
+        dispatch();
+    });
+
+    if (duration > 0)
+        emit probed(url, duration, tags);
+    else
+        emit failed(url);
+}
\ No newline at end of file
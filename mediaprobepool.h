@@ -0,0 +1,65 @@
+#ifndef MEDIAPROBEPOOL_H
+#define MEDIAPROBEPOOL_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QUrl>
+#include <QVariantMap>
+
+QT_BEGIN_NAMESPACE
+class QMediaPlayer;
+class QTimer;
+QT_END_NAMESPACE
+
+// Resolves durations and tags of playlist entries that are not loaded in the
+// main player. A bounded number of muted QMediaPlayer instances without video
+// output are kept busy; prioritized urls (the visible rows) are probed first.
+class MediaProbePool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MediaProbePool(QObject *parent = nullptr);
+    ~MediaProbePool();
+
+    int maxWorkers() const { return m_maxWorkers; }
+    void setMaxWorkers(int count);
+
+    void setTimeout(int msecs) { m_timeout = msecs; }
+
+    void enqueue(const QList<QUrl> &urls);
+    void prioritize(const QList<QUrl> &urls);
+    void clear();
+
+signals:
+    void probed(const QUrl &url, qint64 duration, const QVariantMap &tags);
+    void failed(const QUrl &url);
+
+private:
+    struct Worker
+    {
+        QMediaPlayer *player = nullptr;
+        QTimer *timer = nullptr;
+        QUrl url;
+    };
+
+    void dispatch();
+    bool takeNext(QUrl *url);
+    void startProbe(Worker *worker, const QUrl &url);
+    void checkProbe(Worker *worker);
+    void finishProbe(Worker *worker, bool loaded);
+    Worker *createWorker();
+
+    QList<Worker *> m_workers;
+    QList<Worker *> m_idle;
+    QList<QUrl> m_priorityQueue;
+    QList<QUrl> m_queue;
+    QSet<QUrl> m_queued;
+    QSet<QUrl> m_running;
+    QSet<QUrl> m_done;
+    int m_maxWorkers = 2;
+    int m_timeout = 5000;
+};
+
+#endif // MEDIAPROBEPOOL_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "metadatastore.h"
+#include "tracer.h"
+
+#include <QFile>
+#include <QTextStream>
+
+MetadataStore::MetadataStore(int fieldCount, const QString &fileName)
+    : m_fieldCount(fieldCount)
+    , m_fileName(fileName)
+{
+}
+
+QList<QStringList> MetadataStore::records() const
+{
+    TRACE_SCOPE("MetadataStore::records");
+    QList<QStringList> records;
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return records;
+
+    QTextStream stream(&file);
+    QString line = "";
+    while (!stream.atEnd()) {
+        line += stream.readLine();
+    }
+
+    QStringList videoList = line.split("/");
+    int count = videoList.count() - 1;
+    for (int k = 0; k < count; k++)
+        records.append(videoList.at(k).split(";"));
+
+    return records;
+}
+
+bool MetadataStore::find(const QString &title, QStringList *record) const
+{
+    const QList<QStringList> all = records();
+    for (const QStringList &videoProps : all) {
+        if (videoProps.at(0) == title) {
+            *record = videoProps;
+            return true;
+        }
+    }
+    return false;
+}
+
+// An existing record of the same title is updated and moved to the front;
+// otherwise the record is appended.
+bool MetadataStore::save(const QStringList &record)
+{
+    TRACE_SCOPE("MetadataStore::save");
+    QList<QStringList> all = records();
+
+    int existing = -1;
+    for (int k = 0; k < all.count() && existing < 0; k++) {
+        if (all.at(k).at(0) == record.at(0))
+            existing = k;
+    }
+
+    QFile file(m_fileName);
+    if (!file.open(existing < 0 ? QIODevice::WriteOnly | QIODevice::Append : QIODevice::WriteOnly))
+        return false;
+
+    QTextStream stream(&file);
+    for (int ii = 0; ii < m_fieldCount; ii++) {
+        stream << record.at(ii) << ";";
+    }
+    stream << "/" << endl;
+
+    if (existing >= 0) {
+        for (int kk = 0; kk < all.count(); kk++) {
+            if (kk == existing) {
+                continue;
+            }
+            const QStringList &videoProps = all.at(kk);
+            for (int ii = 0; ii < m_fieldCount; ii++) {
+                stream << videoProps.at(ii) << ";";
+            }
+            stream << "/" << endl;
+        }
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
+
+bool MetadataStore::exportHtml(const QString &fileName) const
+{
+    TRACE_SCOPE("MetadataStore::exportHtml");
+    const QList<QStringList> all = records();
+
+    QFile htmlFile(fileName);
+    if (!htmlFile.open(QIODevice::WriteOnly))
+        return false;
+    QTextStream htmlStream(&htmlFile);
+
+    htmlStream << "<!doctypehtml><style>table{font-family:arial,sans-serif;text-align:left;width:100%}td,th{border:1px solid #ddd;padding:8px}"
+                  "tr:nth-child(even){background-color:#ddd}</style><table><tr><th>Title<th>Author<th>Description<th>Genre<th>Year<th>Date<th>"
+                  "UserRating<th>Language<th>Director<th>Writer<th>Copytight<th>Size<th>MediaType<th>Duration";
+    htmlStream << "  <tr>\n";
+
+    for (const QStringList &videoProps : all) {
+        for (int i = 0; i < m_fieldCount; i++) {
+            htmlStream << "  	<td>";
+            htmlStream << videoProps.at(i);
+            htmlStream << "</td>\n";
+        }
+        htmlStream << "  </tr>\n";
+    }
+
+    htmlStream << "</table>";
+
+    htmlStream.flush();
+    return htmlStream.status() == QTextStream::Ok;
+}
\ No newline at end of file
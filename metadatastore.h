@@ -0,0 +1,30 @@
+#ifndef METADATASTORE_H
+#define METADATASTORE_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// The catalog of edited media information kept in DataQt.txt.
+//
+// Each record is the metadata fields followed by ';', then "/" and a line
+// break. Records are matched by their first field, the title.
+class MetadataStore
+{
+public:
+    explicit MetadataStore(int fieldCount, const QString &fileName = "DataQt.txt");
+
+    QString fileName() const { return m_fileName; }
+    int fieldCount() const { return m_fieldCount; }
+
+    QList<QStringList> records() const;
+    bool find(const QString &title, QStringList *record) const;
+    bool save(const QStringList &record);
+    bool exportHtml(const QString &fileName = "Index.html") const;
+
+private:
+    int m_fieldCount;
+    QString m_fileName;
+};
+
+#endif // METADATASTORE_H
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "monitorwall.h"
+#include "analysispresenter.h"
+#include "histogramwidget.h"
+
+#include <QAudioProbe>
+#include <QGridLayout>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QVideoProbe>
+#include <QVideoWidget>
+#include <QtMath>
+
+MonitorTile::MonitorTile(const QUrl &url, QTimer *repaintTimer, QWidget *parent)
+    : QWidget(parent)
+    , m_url(url)
+{
+    m_player = new QMediaPlayer(this);
+    m_player->setMuted(true);
+
+    m_videoWidget = new QVideoWidget(this);
+    m_videoWidget->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
+    m_videoWidget->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_player->setVideoOutput(m_videoWidget);
+
+    m_titleLabel = new QLabel(url.fileName().isEmpty() ? url.toString() : url.fileName(), this);
+    m_titleLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Preferred);
+
+    m_videoHistogram = new HistogramWidget(this);
+    m_videoHistogram->setRepaintTimer(repaintTimer);
+    m_videoHistogram->setMinimumHeight(24);
+    m_audioHistogram = new HistogramWidget(this);
+    m_audioHistogram->setRepaintTimer(repaintTimer);
+
+    AnalysisPresenter *presenter = new AnalysisPresenter(this);
+    presenter->setPlayer(m_player);
+    m_videoHistogram->setPresenter(presenter);
+    m_audioHistogram->setPresenter(presenter);
+
+    m_videoProbe = new QVideoProbe(this);
+    connect(m_videoProbe, &QVideoProbe::videoFrameProbed, m_videoHistogram, &HistogramWidget::processFrame);
+    m_videoProbe->setSource(m_player);
+
+    m_audioProbe = new QAudioProbe(this);
+    connect(m_audioProbe, &QAudioProbe::audioBufferProbed, m_audioHistogram, &HistogramWidget::processBuffer);
+    m_audioProbe->setSource(m_player);
+
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &MonitorTile::statusChanged);
+    connect(m_player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, &MonitorTile::displayError);
+
+    QHBoxLayout *meters = new QHBoxLayout;
+    meters->addWidget(m_videoHistogram, 1);
+    meters->addWidget(m_audioHistogram, 1);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->setMargin(2);
+    layout->setSpacing(2);
+    layout->addWidget(m_videoWidget, 1);
+    layout->addWidget(m_titleLabel);
+    layout->addLayout(meters);
+    setLayout(layout);
+    setAutoFillBackground(true);
+
+    m_player->setMedia(QMediaContent(url));
+    m_player->play();
+}
+
+void MonitorTile::setFrameBudget(int fps)
+{
+    m_videoHistogram->setFrameInterval(fps > 0 ? 1000 / fps : 0);
+}
+
+void MonitorTile::setHistogramLevels(int levels)
+{
+    m_videoHistogram->setLevels(levels);
+}
+
+void MonitorTile::setSolo(bool solo)
+{
+    m_player->setMuted(!solo);
+    QPalette p = palette();
+    p.setColor(QPalette::Window, solo ? palette().color(QPalette::Highlight) : QColor(Qt::black));
+    setPalette(p);
+}
+
+void MonitorTile::mousePressEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    emit clicked(this);
+}
+
+// Files on the wall loop; live streams never end.
+void MonitorTile::statusChanged(QMediaPlayer::MediaStatus status)
+{
+    if (status == QMediaPlayer::EndOfMedia) {
+        m_player->setPosition(0);
+        m_player->play();
+    }
+}
+
+void MonitorTile::displayError()
+{
+    m_titleLabel->setText(tr("%1: %2").arg(m_url.fileName(), m_player->errorString()));
+}
+
+MonitorWall::MonitorWall(QWidget *parent)
+    : QWidget(parent)
+{
+    m_layout = new QGridLayout;
+    m_layout->setSpacing(2);
+    m_layout->setMargin(2);
+    setLayout(m_layout);
+
+    QPalette p = palette();
+    p.setColor(QPalette::Window, Qt::black);
+    p.setColor(QPalette::WindowText, Qt::white);
+    setPalette(p);
+    setAutoFillBackground(true);
+
+    m_repaintTimer.setInterval(100);
+    m_repaintTimer.start();
+}
+
+void MonitorWall::setColumns(int columns)
+{
+    m_columns = qMax(0, columns);
+    relayout();
+}
+
+void MonitorWall::setFrameBudget(int fps)
+{
+    m_frameBudget = fps;
+    for (MonitorTile *tile : qAsConst(m_tiles))
+        tile->setFrameBudget(fps);
+}
+
+void MonitorWall::addFeeds(const QList<QUrl> &urls)
+{
+    for (const QUrl &url : urls) {
+        MonitorTile *tile = new MonitorTile(url, &m_repaintTimer, this);
+        tile->setFrameBudget(m_frameBudget);
+        tile->setHistogramLevels(64);
+        tile->setSolo(false);
+        connect(tile, &MonitorTile::clicked, this, &MonitorWall::soloTile);
+        m_tiles.append(tile);
+    }
+    relayout();
+}
+
+void MonitorWall::relayout()
+{
+    const int columns = m_columns ? m_columns : qMax(1, qCeil(qSqrt(m_tiles.size())));
+    for (MonitorTile *tile : qAsConst(m_tiles))
+        m_layout->removeWidget(tile);
+    for (int i = 0; i < m_tiles.size(); ++i)
+        m_layout->addWidget(m_tiles.at(i), i / columns, i % columns);
+}
+
+void MonitorWall::soloTile(MonitorTile *tile)
+{
+    if (m_soloTile)
+        m_soloTile->setSolo(false);
+
+    m_soloTile = tile == m_soloTile ? nullptr : tile;
+    if (m_soloTile)
+        m_soloTile->setSolo(true);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef MONITORWALL_H
+#define MONITORWALL_H
+
+#include <QList>
+#include <QMediaPlayer>
+#include <QTimer>
+#include <QUrl>
+#include <QWidget>
+
+QT_BEGIN_NAMESPACE
+class QAudioProbe;
+class QGridLayout;
+class QLabel;
+class QVideoProbe;
+class QVideoWidget;
+QT_END_NAMESPACE
+
+class HistogramWidget;
+
+// One feed of the wall: video, luma histogram and audio levels. Repaints
+// follow the wall's timer.
+class MonitorTile : public QWidget
+{
+    Q_OBJECT
+
+public:
+    MonitorTile(const QUrl &url, QTimer *repaintTimer, QWidget *parent = nullptr);
+
+    QUrl url() const { return m_url; }
+    QMediaPlayer *player() const { return m_player; }
+
+    void setFrameBudget(int fps);
+    void setHistogramLevels(int levels);
+    void setSolo(bool solo);
+
+signals:
+    void clicked(MonitorTile *tile);
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+
+private slots:
+    void statusChanged(QMediaPlayer::MediaStatus status);
+    void displayError();
+
+private:
+    QUrl m_url;
+    QMediaPlayer *m_player = nullptr;
+    QVideoWidget *m_videoWidget = nullptr;
+    QLabel *m_titleLabel = nullptr;
+    HistogramWidget *m_videoHistogram = nullptr;
+    HistogramWidget *m_audioHistogram = nullptr;
+    QVideoProbe *m_videoProbe = nullptr;
+    QAudioProbe *m_audioProbe = nullptr;
+};
+
+// Grid of feeds played and analyzed in one process. All tiles share the
+// analysis executor and a single repaint timer; every tile analyzes at most a
+// given number of frames per second. Clicking a tile plays its audio.
+class MonitorWall : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MonitorWall(QWidget *parent = nullptr);
+
+    void setColumns(int columns);
+    void setFrameBudget(int fps);
+    void setRepaintInterval(int msecs) { m_repaintTimer.setInterval(msecs); }
+
+    void addFeeds(const QList<QUrl> &urls);
+
+private slots:
+    void soloTile(MonitorTile *tile);
+
+private:
+    void relayout();
+
+    QGridLayout *m_layout = nullptr;
+    QList<MonitorTile *> m_tiles;
+    QTimer m_repaintTimer;
+    MonitorTile *m_soloTile = nullptr;
+    int m_columns = 0;
+    int m_frameBudget = 5;
+};
+
+#endif // MONITORWALL_H
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "overviewwidget.h"
+#include "analysiscache.h"
+#include "tracer.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+
+OverviewWidget::OverviewWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(16);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setCursor(Qt::PointingHandCursor);
+}
+
+void OverviewWidget::setCache(AnalysisCache *cache)
+{
+    if (m_cache)
+        disconnect(m_cache, nullptr, this, nullptr);
+
+    m_cache = cache;
+    if (m_cache) {
+        // A media change replaces the seconds, possibly by none at all.
+        connect(m_cache, &AnalysisCache::loaded, this, &OverviewWidget::rebuild);
+        connect(m_cache, &AnalysisCache::secondsChanged, this, &OverviewWidget::secondsChanged);
+    }
+
+    rebuild();
+}
+
+QSize OverviewWidget::sizeHint() const
+{
+    return QSize(200, 24);
+}
+
+void OverviewWidget::setPosition(qint64 position)
+{
+    m_position = position;
+    update();
+}
+
+OverviewWidget::Entry OverviewWidget::merge(const Entry &a, const Entry &b)
+{
+    Entry entry;
+    entry.flags = a.flags | b.flags;
+    entry.loudness = qMax(a.loudness, b.loudness);
+
+    const bool aVideo = a.flags & AnalysisCache::HasVideo;
+    const bool bVideo = b.flags & AnalysisCache::HasVideo;
+    if (aVideo && bVideo)
+        entry.luma = quint8((a.luma + b.luma + 1) / 2);
+    else
+        entry.luma = aVideo ? a.luma : b.luma;
+    return entry;
+}
+
+void OverviewWidget::setLoopRange(qint64 start, qint64 end)
+{
+    m_loopStart = start;
+    m_loopEnd = end;
+    update();
+}
+
+void OverviewWidget::rebuild()
+{
+    m_pyramid.clear();
+    const int count = m_cache ? m_cache->secondCount() : 0;
+    if (count)
+        secondsChanged(0, count - 1);
+    m_dirty = true;
+    update();
+}
+
+// Refreshes the changed seconds and the entries above them, level by level.
+void OverviewWidget::secondsChanged(int first, int last)
+{
+    const QVector<AnalysisCache::Second> &seconds = m_cache->seconds();
+    if (m_pyramid.isEmpty() || m_pyramid.first().size() != seconds.size()) {
+        m_pyramid.clear();
+        if (seconds.isEmpty()) {
+            m_dirty = true;
+            update();
+            return;
+        }
+        for (int size = seconds.size(); ; size = (size + 1) / 2) {
+            m_pyramid.append(QVector<Entry>(size));
+            if (size == 1)
+                break;
+        }
+        first = 0;
+        last = seconds.size() - 1;
+    }
+
+    QVector<Entry> &base = m_pyramid[0];
+    for (int i = first; i <= last; ++i) {
+        base[i].flags = seconds[i].flags;
+        base[i].luma = seconds[i].luma;
+        base[i].loudness = seconds[i].loudness;
+    }
+
+    for (int level = 1; level < m_pyramid.size(); ++level) {
+        first >>= 1;
+        last >>= 1;
+        const QVector<Entry> &below = m_pyramid[level - 1];
+        QVector<Entry> &entries = m_pyramid[level];
+        for (int i = first; i <= last; ++i) {
+            if (2 * i + 1 < below.size())
+                entries[i] = merge(below[2 * i], below[2 * i + 1]);
+            else
+                entries[i] = below[2 * i];
+        }
+    }
+
+    m_dirty = true;
+    update();
+}
+
+void OverviewWidget::render()
+{
+    TRACE_SCOPE("OverviewWidget::render");
+    m_image = QImage(qMax(1, width()), qMax(1, height()), QImage::Format_RGB32);
+    m_image.fill(Qt::black);
+    m_dirty = false;
+
+    if (m_pyramid.isEmpty())
+        return;
+
+    const int count = m_pyramid.first().size();
+    const int w = m_image.width();
+    const int h = m_image.height();
+    const int lumaHeight = h / 2;
+
+    int level = 0;
+    while (level + 1 < m_pyramid.size() && (count >> (level + 1)) >= w)
+        ++level;
+    const QVector<Entry> &entries = m_pyramid.at(level);
+
+    QPainter painter(&m_image);
+    for (int x = 0; x < w; ++x) {
+        const int s0 = int(qint64(x) * count / w);
+        const int s1 = qMax(s0 + 1, int(qint64(x + 1) * count / w));
+        const int e0 = s0 >> level;
+        const int e1 = qMin(entries.size(), qMax(e0 + 1, (s1 + (1 << level) - 1) >> level));
+
+        Entry entry = entries.at(e0);
+        for (int i = e0 + 1; i < e1; ++i)
+            entry = merge(entry, entries.at(i));
+
+        if (entry.flags & AnalysisCache::HasVideo)
+            painter.fillRect(x, 0, 1, lumaHeight, QColor(entry.luma, entry.luma, entry.luma));
+        else
+            painter.fillRect(x, 0, 1, lumaHeight, QColor(32, 32, 48));
+
+        if (entry.flags & AnalysisCache::HasAudio) {
+            const int barHeight = entry.loudness * (h - lumaHeight) / 255;
+            painter.fillRect(x, h - barHeight, 1, barHeight, Qt::red);
+        }
+    }
+}
+
+qint64 OverviewWidget::positionAt(int x) const
+{
+    if (m_pyramid.isEmpty() || width() <= 0)
+        return -1;
+
+    const qint64 duration = qint64(m_pyramid.first().size()) * 1000;
+    return qBound<qint64>(0, qint64(x) * duration / width(), duration - 1);
+}
+
+void OverviewWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    if (m_dirty || m_image.size() != size())
+        render();
+
+    QPainter painter(this);
+    painter.drawImage(0, 0, m_image);
+
+    if (!m_pyramid.isEmpty()) {
+        const qint64 duration = qint64(m_pyramid.first().size()) * 1000;
+        if (m_loopStart >= 0) {
+            const int start = int(m_loopStart * width() / duration);
+            const int end = m_loopEnd > m_loopStart ? int(m_loopEnd * width() / duration) : start + 1;
+            painter.fillRect(start, 0, qMax(1, end - start), height(), QColor(64, 128, 255, 96));
+        }
+
+        const int x = int(m_position * width() / duration);
+        painter.fillRect(x, 0, 1, height(), Qt::yellow);
+    }
+}
+
+void OverviewWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_dirty = true;
+}
+
+void OverviewWidget::mousePressEvent(QMouseEvent *event)
+{
+    qint64 position = positionAt(event->pos().x());
+    if (event->button() == Qt::LeftButton && position >= 0)
+        emit seekRequested(position);
+}
+
+void OverviewWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    qint64 position = positionAt(event->pos().x());
+    if ((event->buttons() & Qt::LeftButton) && position >= 0)
+        emit seekRequested(position);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef OVERVIEWWIDGET_H
+#define OVERVIEWWIDGET_H
+
+#include <QImage>
+#include <QVector>
+#include <QWidget>
+
+class AnalysisCache;
+
+// Timeline strip of the whole media: mean luma on top, audio peak level below.
+//
+// The per-second summaries of the analysis cache are kept in a pyramid of
+// pairwise merged levels. A redraw reads the finest level that still has no
+// more than about two entries per pixel, so its cost follows the width of the
+// strip, not the duration of the media.
+class OverviewWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit OverviewWidget(QWidget *parent = nullptr);
+
+    void setCache(AnalysisCache *cache);
+    QSize sizeHint() const override;
+
+public slots:
+    void setPosition(qint64 position);
+    void setLoopRange(qint64 start, qint64 end);
+
+signals:
+    void seekRequested(qint64 position);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private slots:
+    void secondsChanged(int first, int last);
+
+private:
+    struct Entry
+    {
+        quint8 flags = 0;
+        quint8 luma = 0;
+        quint8 loudness = 0;
+    };
+
+    static Entry merge(const Entry &a, const Entry &b);
+    void rebuild();
+    void render();
+    qint64 positionAt(int x) const;
+
+    AnalysisCache *m_cache = nullptr;
+    QVector<QVector<Entry>> m_pyramid;
+    QImage m_image;
+    bool m_dirty = true;
+    qint64 m_position = 0;
+    qint64 m_loopStart = -1;
+    qint64 m_loopEnd = -1;
+};
+
+#endif // OVERVIEWWIDGET_H
\ No newline at end of file
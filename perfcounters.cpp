@@ -0,0 +1,157 @@
+#include "perfcounters.h"
+
+#include <QAtomicInteger>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+
+namespace {
+
+struct Storage
+{
+    QAtomicInteger<qint64> counters[PerfCounters::CounterCount];
+    QAtomicInteger<qint64> samples[PerfCounters::StageCount];
+    QAtomicInteger<qint64> total[PerfCounters::StageCount];
+    QAtomicInteger<qint64> buckets[PerfCounters::StageCount][PerfCounters::BucketCount];
+};
+
+Storage storage;
+
+const char *const stageNames[PerfCounters::StageCount] = {
+    "histogram",
+    "probe->histogram",
+    "audio levels",
+    "histogram paint",
+    "video paint",
+    "result latency",
+    "frame encode"
+};
+
+QElapsedTimer startedTimer()
+{
+    QElapsedTimer timer;
+    timer.start();
+    return timer;
+}
+
+// Upper bound of the bucket holding the given fraction of the samples.
+qint64 percentile(const qint64 *buckets, qint64 samples, qreal fraction)
+{
+    qint64 threshold = qint64(samples * fraction);
+    qint64 seen = 0;
+    for (int i = 0; i < PerfCounters::BucketCount; ++i) {
+        seen += buckets[i];
+        if (seen > threshold)
+            return qint64(2) << i;
+    }
+    return qint64(1) << PerfCounters::BucketCount;
+}
+
+QString formatNsecs(qint64 nsecs)
+{
+    if (nsecs >= 1000000)
+        return QString::number(nsecs / 1e6, 'f', 1) + " ms";
+    return QString::number(nsecs / 1e3, 'f', 0) + " us";
+}
+
+}
+
+qint64 PerfCounters::now()
+{
+    static const QElapsedTimer timer = startedTimer();
+    return timer.nsecsElapsed();
+}
+
+void PerfCounters::increment(Counter counter, qint64 amount)
+{
+    storage.counters[counter].fetchAndAddRelaxed(amount);
+}
+
+void PerfCounters::addSample(Stage stage, qint64 nsecs)
+{
+    nsecs = qMax<qint64>(1, nsecs);
+    int bucket = qMin(BucketCount - 1, 63 - int(qCountLeadingZeroBits(quint64(nsecs))));
+    storage.samples[stage].fetchAndAddRelaxed(1);
+    storage.total[stage].fetchAndAddRelaxed(nsecs);
+    storage.buckets[stage][bucket].fetchAndAddRelaxed(1);
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.time = now();
+    for (int i = 0; i < CounterCount; ++i)
+        snapshot.counters[i] = storage.counters[i].load();
+    for (int i = 0; i < StageCount; ++i) {
+        snapshot.samples[i] = storage.samples[i].load();
+        snapshot.total[i] = storage.total[i].load();
+        for (int j = 0; j < BucketCount; ++j)
+            snapshot.buckets[i][j] = storage.buckets[i][j].load();
+    }
+    return snapshot;
+}
+
+QString PerfCounters::format(const Snapshot &current, const Snapshot &previous)
+{
+    qreal seconds = qMax<qint64>(1, current.time - previous.time) / 1e9;
+    qint64 frames = current.counters[FramesProbed] - previous.counters[FramesProbed];
+    qint64 dropped = current.counters[FramesDropped] - previous.counters[FramesDropped];
+    qint64 stale = current.counters[StaleResults] - previous.counters[StaleResults];
+
+    QStringList lines;
+    lines << QString("decode %1 fps, histogram dropped %2 (%3 total), stale results %4")
+             .arg(frames / seconds, 0, 'f', 1)
+             .arg(dropped)
+             .arg(current.counters[FramesDropped])
+             .arg(stale);
+
+    for (int i = 0; i < StageCount; ++i) {
+        qint64 samples = current.samples[i] - previous.samples[i];
+        if (!samples)
+            continue;
+
+        qint64 buckets[BucketCount];
+        for (int j = 0; j < BucketCount; ++j)
+            buckets[j] = current.buckets[i][j] - previous.buckets[i][j];
+
+        lines << QString("%1: n %2, avg %3, p50 < %4, p99 < %5")
+                 .arg(QLatin1String(stageNames[i]))
+                 .arg(samples)
+                 .arg(formatNsecs((current.total[i] - previous.total[i]) / samples))
+                 .arg(formatNsecs(percentile(buckets, samples, 0.5)))
+                 .arg(formatNsecs(percentile(buckets, samples, 0.99)));
+    }
+
+    return lines.join('\n');
+}
+
+PerfLogger::PerfLogger(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &PerfLogger::dump);
+}
+
+bool PerfLogger::open(const QString &fileName, int intervalMsecs)
+{
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return false;
+
+    m_previous = PerfCounters::snapshot();
+    m_timer.start(intervalMsecs);
+    return true;
+}
+
+void PerfLogger::dump()
+{
+    PerfCounters::Snapshot current = PerfCounters::snapshot();
+    QString text = PerfCounters::format(current, m_previous);
+    m_previous = current;
+
+    QString stamp = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    QByteArray line;
+    for (const QString &part : text.split('\n'))
+        line += stamp.toUtf8() + ' ' + part.toUtf8() + '\n';
+    m_file.write(line);
+    m_file.flush();
+}
\ No newline at end of file
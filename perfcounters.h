@@ -0,0 +1,95 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// Process wide counters and per-stage latency histograms.
+//
+// Everything is a relaxed atomic, so the pipeline threads can record on every
+// frame without locking. Latencies go into power-of-two nanosecond buckets;
+// readers take snapshots and report the difference between two of them.
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        FramesProbed,
+        FramesDropped,
+        AudioBuffers,
+        StaleResults,
+        CounterCount
+    };
+
+    enum Stage
+    {
+        HistogramCompute,
+        ProbeToHistogram,
+        AudioLevels,
+        HistogramPaint,
+        VideoPaint,
+        ResultLatency,
+        FrameEncode,
+        StageCount
+    };
+
+    static const int BucketCount = 40;
+
+    struct Snapshot
+    {
+        qint64 time = 0;
+        qint64 counters[CounterCount] = {};
+        qint64 samples[StageCount] = {};
+        qint64 total[StageCount] = {};
+        qint64 buckets[StageCount][BucketCount] = {};
+    };
+
+    static qint64 now();
+    static void increment(Counter counter, qint64 amount = 1);
+    static void addSample(Stage stage, qint64 nsecs);
+
+    static Snapshot snapshot();
+    static QString format(const Snapshot &current, const Snapshot &previous);
+};
+
+class PerfTimer
+{
+public:
+    explicit PerfTimer(PerfCounters::Stage stage)
+        : m_stage(stage)
+        , m_start(PerfCounters::now())
+    {
+    }
+
+    ~PerfTimer()
+    {
+        PerfCounters::addSample(m_stage, PerfCounters::now() - m_start);
+    }
+
+private:
+    PerfCounters::Stage m_stage;
+    qint64 m_start;
+};
+
+// Appends a line with the counters of the last interval to a log file.
+class PerfLogger : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PerfLogger(QObject *parent = nullptr);
+
+    bool open(const QString &fileName, int intervalMsecs = 5000);
+
+private slots:
+    void dump();
+
+private:
+    QFile m_file;
+    QTimer m_timer;
+    PerfCounters::Snapshot m_previous;
+};
+
+#endif // PERFCOUNTERS_H
\ No newline at end of file
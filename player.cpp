@@ -2,7 +2,19 @@
 #include "playercontrols.h"
 #include "playlistmodel.h"
 #include "histogramwidget.h"
+#include "scopewidget.h"
 #include "videowidget.h"
+#include "sessionstore.h"
+#include "mediaprobepool.h"
+#include "thumbnailcache.h"
+#include "analysiscache.h"
+#include "overviewwidget.h"
+#include "timestretch.h"
+#include "analysispresenter.h"
+#include "frameexporter.h"
+#include "seekcontroller.h"
+#include "positionpresenter.h"
+#include "tracer.h"
 #include <QMediaService>
 #include <QMediaPlaylist>
 #include <QVideoProbe>
@@ -10,8 +22,12 @@
 #include <QMediaMetaData>
 #include <QtWidgets>
 
+// Shortest A/B loop, in milliseconds.
+static const qint64 MinLoopDuration = 100;
+
 Player::Player(QWidget *parent)
     : QWidget(parent)
+    , m_metadataStore(metadata.count())
 {
 //! [create-objs]
     m_player = new QMediaPlayer(this);
@@ -24,14 +40,7 @@ Player::Player(QWidget *parent)
     m_player->setPlaylist(m_playlist);
 //! [create-objs]
 
-    connect(m_player, &QMediaPlayer::durationChanged, this, &Player::durationChanged);
-    connect(m_player, &QMediaPlayer::positionChanged, this, &Player::positionChanged);
-    connect(m_player, QOverload<>::of(&QMediaPlayer::metaDataChanged), this, &Player::metaDataChanged);
     connect(m_playlist, &QMediaPlaylist::currentIndexChanged, this, &Player::playlistPositionChanged);
-    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &Player::statusChanged);
-    connect(m_player, &QMediaPlayer::videoAvailableChanged, this, &Player::videoAvailableChanged);
-    connect(m_player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, &Player::displayErrorMessage);
-    connect(m_player, &QMediaPlayer::stateChanged, this, &Player::stateChanged);
 
 //! [2]
     m_videoWidget = new VideoWidget(this);
@@ -41,34 +50,144 @@ Player::Player(QWidget *parent)
     m_playlistModel->setPlaylist(m_playlist);
 //! [2]
 
-    m_playlistView = new QListView(this);
-    m_playlistView->setModel(m_playlistModel);
+    QTreeView *playlistView = new QTreeView(this);
+    playlistView->setRootIsDecorated(false);
+    playlistView->setUniformRowHeights(true);
+    playlistView->setModel(m_playlistModel);
+    playlistView->header()->setStretchLastSection(false);
+    playlistView->header()->setSectionResizeMode(PlaylistModel::Title, QHeaderView::Stretch);
+    playlistView->header()->resizeSection(PlaylistModel::Duration,
+                                          playlistView->fontMetrics().width(QStringLiteral("00:00:00 ")));
+    m_playlistView = playlistView;
     m_playlistView->setCurrentIndex(m_playlistModel->index(m_playlist->currentIndex(), 0));
 
     connect(m_playlistView, &QAbstractItemView::activated, this, &Player::jump);
 
+    m_labelPlaylistDuration = new QLabel(this);
+    connect(m_playlistModel, &PlaylistModel::totalDurationChanged, this, &Player::updatePlaylistDuration);
+    connect(m_playlistModel, &QAbstractItemModel::rowsInserted, this, &Player::updatePlaylistDuration);
+    connect(m_playlistModel, &QAbstractItemModel::rowsRemoved, this, &Player::updatePlaylistDuration);
+
+    m_probePool = new MediaProbePool(this);
+    connect(m_probePool, &MediaProbePool::probed, this, &Player::mediaProbed);
+    connect(m_playlistModel, &QAbstractItemModel::rowsInserted, this, &Player::enqueueProbes);
+    // An emptied playlist starts over, so files added again are probed again.
+    connect(m_playlistModel, &QAbstractItemModel::rowsRemoved, this, [this]() {
+        if (!m_playlistModel->rowCount())
+            m_probePool->clear();
+    });
+
+    m_visibleProbeTimer = new QTimer(this);
+    m_visibleProbeTimer->setSingleShot(true);
+    m_visibleProbeTimer->setInterval(100);
+    connect(m_visibleProbeTimer, &QTimer::timeout, this, &Player::prioritizeVisibleProbes);
+    connect(m_playlistView->verticalScrollBar(), &QScrollBar::valueChanged,
+            m_visibleProbeTimer, QOverload<>::of(&QTimer::start));
+
     m_slider = new QSlider(Qt::Horizontal, this);
-    m_slider->setRange(0, m_player->duration() / 1000);
+    m_slider->setRange(0, m_player->duration());
+    m_slider->setSingleStep(1000);
+    m_slider->setPageStep(10000);
+
+    m_seekController = new SeekController(this);
 
     m_labelDuration = new QLabel(this);
+    m_positionPresenter = new PositionPresenter(m_labelDuration, this);
     connect(m_slider, &QSlider::sliderMoved, this, &Player::seek);
+    connect(m_slider, &QSlider::sliderReleased, this, [this]() {
+        m_seekController->seekNow(m_slider->value());
+    });
+
+    QShortcut *frameForward = new QShortcut(QKeySequence(Qt::Key_Period), this);
+    connect(frameForward, &QShortcut::activated, this, [this]() { m_seekController->stepFrames(1); });
+    QShortcut *frameBackward = new QShortcut(QKeySequence(Qt::Key_Comma), this);
+    connect(frameBackward, &QShortcut::activated, this, [this]() { m_seekController->stepFrames(-1); });
+    QShortcut *trace = new QShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_T), this);
+    connect(trace, &QShortcut::activated, this, &Player::toggleTrace);
+    QShortcut *snapshot = new QShortcut(QKeySequence(Qt::Key_S), this);
+    connect(snapshot, &QShortcut::activated, this, &Player::grabFrame);
+    QShortcut *burst = new QShortcut(QKeySequence(Qt::SHIFT + Qt::Key_S), this);
+    connect(burst, &QShortcut::activated, this, &Player::toggleBurst);
+    QShortcut *perfOverlay = new QShortcut(QKeySequence(Qt::Key_F12), this);
+    connect(perfOverlay, &QShortcut::activated, this, [this]() {
+        m_videoWidget->setPerfOverlayVisible(!m_videoWidget->isPerfOverlayVisible());
+    });
+
+    m_thumbnails = new ThumbnailCache(this);
+    connect(m_thumbnails, &ThumbnailCache::thumbnailReady, this, &Player::thumbnailReady);
+
+    m_thumbnailPreview = new QLabel(this, Qt::ToolTip);
+    m_thumbnailPreview->setAlignment(Qt::AlignCenter);
+    m_thumbnailPreview->setFrameShape(QFrame::Box);
+    m_slider->setMouseTracking(true);
+    m_slider->installEventFilter(this);
 
     m_labelHistogram = new QLabel(this);
     m_labelHistogram->setText("Histogram:");
     m_videoHistogram = new HistogramWidget(this);
     m_audioHistogram = new HistogramWidget(this);
+    m_histogramMode = new QComboBox(this);
+    m_histogramMode->addItem(tr("Instant"), HistogramAccumulator::Instant);
+    m_histogramMode->addItem(tr("Smoothed"), HistogramAccumulator::Exponential);
+    m_histogramMode->addItem(tr("Last 50 frames"), HistogramAccumulator::Window);
+    m_histogramMode->addItem(tr("Whole clip"), HistogramAccumulator::Cumulative);
+    connect(m_histogramMode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_videoHistogram->setAccumulation(HistogramAccumulator::Mode(m_histogramMode->currentData().toInt()));
+    });
     QHBoxLayout *histogramLayout = new QHBoxLayout;
     histogramLayout->addWidget(m_labelHistogram);
+    histogramLayout->addWidget(m_histogramMode);
     histogramLayout->addWidget(m_videoHistogram, 1);
     histogramLayout->addWidget(m_audioHistogram, 2);
 
+    m_scopeSelector = new QComboBox(this);
+    m_scopeSelector->addItem(tr("No scope"));
+    m_scopeSelector->addItem(tr("Waveform"));
+    m_scopeSelector->addItem(tr("Vectorscope"));
+    m_scopeWidget = new ScopeWidget(this);
+    m_scopeWidget->hide();
+    connect(m_scopeSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        if (index > 0)
+            m_scopeWidget->setMode(index == 1 ? ScopeWidget::Waveform : ScopeWidget::Vectorscope);
+        m_scopeWidget->setVisible(index > 0);
+    });
+    histogramLayout->addWidget(m_scopeSelector);
+    histogramLayout->addWidget(m_scopeWidget, 1);
+
+    m_analysisPresenter = new AnalysisPresenter(this);
+    m_videoHistogram->setPresenter(m_analysisPresenter);
+    m_audioHistogram->setPresenter(m_analysisPresenter);
+    m_scopeWidget->setPresenter(m_analysisPresenter);
+
     m_videoProbe = new QVideoProbe(this);
     connect(m_videoProbe, &QVideoProbe::videoFrameProbed, m_videoHistogram, &HistogramWidget::processFrame);
-    m_videoProbe->setSource(m_player);
+    connect(m_videoHistogram, &HistogramWidget::sceneEvent, this, &Player::sceneEvent);
+    connect(m_videoProbe, &QVideoProbe::videoFrameProbed, m_scopeWidget, &ScopeWidget::processFrame);
+
+    m_frameExporter = new FrameExporter(this);
+    connect(m_videoProbe, &QVideoProbe::videoFrameProbed, m_frameExporter, &FrameExporter::processFrame);
+    connect(m_frameExporter, &FrameExporter::frameSaved, this, [this](const QString &fileName) {
+        if (!m_frameExporter->isBursting())
+            showMessage(tr("Frame saved to %1").arg(fileName), 3000);
+    });
+    connect(m_frameExporter, &FrameExporter::frameFailed, this, [this](const QString &fileName) {
+        showMessage(tr("Cannot write %1").arg(fileName), 5000);
+    });
 
     m_audioProbe = new QAudioProbe(this);
     connect(m_audioProbe, &QAudioProbe::audioBufferProbed, m_audioHistogram, &HistogramWidget::processBuffer);
-    m_audioProbe->setSource(m_player);
+
+    m_timeStretch = new TimeStretchOutput(this);
+    connect(m_audioProbe, &QAudioProbe::audioBufferProbed, m_timeStretch, &TimeStretchOutput::processBuffer);
+
+    m_analysisCache = new AnalysisCache(this);
+    connect(m_videoHistogram, &HistogramWidget::frameAnalyzed, m_analysisCache, &AnalysisCache::addFrame);
+    connect(m_audioHistogram, &HistogramWidget::levelsReady, m_analysisCache, &AnalysisCache::addLevels);
+    connect(m_analysisCache, &AnalysisCache::loaded, this, &Player::updateProbeSources);
+
+    m_overview = new OverviewWidget(this);
+    m_overview->setCache(m_analysisCache);
+    connect(m_overview, &OverviewWidget::seekRequested, m_seekController, &SeekController::seek);
 
     QPushButton *openButton = new QPushButton(tr("Open"), this);
 
@@ -78,20 +197,26 @@ Player::Player(QWidget *parent)
     controls->setState(m_player->state());
     controls->setVolume(m_player->volume());
     controls->setMuted(controls->isMuted());
+    m_controls = controls;
 
-    connect(controls, &PlayerControls::play, m_player, &QMediaPlayer::play);
-    connect(controls, &PlayerControls::pause, m_player, &QMediaPlayer::pause);
-    connect(controls, &PlayerControls::stop, m_player, &QMediaPlayer::stop);
     connect(controls, &PlayerControls::next, m_playlist, &QMediaPlaylist::next);
     connect(controls, &PlayerControls::previous, this, &Player::previousClicked);
-    connect(controls, &PlayerControls::changeVolume, m_player, &QMediaPlayer::setVolume);
-    connect(controls, &PlayerControls::changeMuting, m_player, &QMediaPlayer::setMuted);
-    connect(controls, &PlayerControls::changeRate, m_player, &QMediaPlayer::setPlaybackRate);
+    connect(controls, &PlayerControls::changeMuting, this, &Player::setMuted);
+    connect(controls, &PlayerControls::stepFrame, m_seekController, &SeekController::stepFrames);
+    connect(controls, &PlayerControls::markLoopStart, this, &Player::markLoopStart);
+    connect(controls, &PlayerControls::markLoopEnd, this, &Player::markLoopEnd);
+    connect(controls, &PlayerControls::clearLoop, this, &Player::clearLoop);
+
+    m_loopTimer = new QTimer(this);
+    m_loopTimer->setSingleShot(true);
+    m_loopTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_loopTimer, &QTimer::timeout, this, &Player::loopBack);
+    connect(controls, &PlayerControls::changeVolume, m_timeStretch, &TimeStretchOutput::setVolume);
+    connect(controls, &PlayerControls::changePitchCorrection, this, &Player::setPitchCorrection);
+    m_timeStretch->setVolume(m_player->volume());
     connect(controls, &PlayerControls::stop, m_videoWidget, QOverload<>::of(&QVideoWidget::update));
 
-    connect(m_player, &QMediaPlayer::stateChanged, controls, &PlayerControls::setState);
-    connect(m_player, &QMediaPlayer::volumeChanged, controls, &PlayerControls::setVolume);
-    connect(m_player, &QMediaPlayer::mutedChanged, controls, &PlayerControls::setMuted);
+    connectPlayer(m_player);
 
     m_fullScreenButton = new QPushButton(tr("FullScreen"), this);
     m_fullScreenButton->setCheckable(true);
@@ -104,9 +229,18 @@ Player::Player(QWidget *parent)
     m_infoButton->setEnabled(false);
     connect(m_infoButton, &QPushButton::clicked, this, &Player::showInfoDialog);
 
+    m_snapshotButton = new QPushButton(tr("Snapshot"), this);
+    m_snapshotButton->setEnabled(false);
+    m_snapshotButton->setToolTip(tr("Save the current frame (S), Shift+S toggles a burst"));
+    connect(m_snapshotButton, &QPushButton::clicked, this, &Player::grabFrame);
+
+    QBoxLayout *playlistLayout = new QVBoxLayout;
+    playlistLayout->addWidget(m_playlistView);
+    playlistLayout->addWidget(m_labelPlaylistDuration);
+
     QBoxLayout *displayLayout = new QHBoxLayout;
     displayLayout->addWidget(m_videoWidget, 2);
-    displayLayout->addWidget(m_playlistView);
+    displayLayout->addLayout(playlistLayout);
 
     QBoxLayout *controlLayout = new QHBoxLayout;
     controlLayout->setMargin(0);
@@ -117,6 +251,7 @@ Player::Player(QWidget *parent)
     controlLayout->addWidget(m_fullScreenButton);
     controlLayout->addWidget(m_colorButton);
     controlLayout->addWidget(m_infoButton);
+    controlLayout->addWidget(m_snapshotButton);
 
     QBoxLayout *layout = new QVBoxLayout;
     layout->addLayout(displayLayout);
@@ -124,8 +259,15 @@ Player::Player(QWidget *parent)
     hLayout->addWidget(m_slider);
     hLayout->addWidget(m_labelDuration);
     layout->addLayout(hLayout);
+    layout->addWidget(m_overview);
     layout->addLayout(controlLayout);
     layout->addLayout(histogramLayout);
+
+    m_messageLabel = new QLabel(this);
+    m_messageTimer = new QTimer(this);
+    m_messageTimer->setSingleShot(true);
+    connect(m_messageTimer, &QTimer::timeout, m_messageLabel, &QLabel::clear);
+    layout->addWidget(m_messageLabel);
 #if defined(Q_OS_QNX)
     // On QNX, the main window doesn't have a title bar (or any other decorations).
     // Create a status bar for the status information instead.
@@ -149,6 +291,7 @@ Player::Player(QWidget *parent)
         m_colorButton->setEnabled(false);
         m_fullScreenButton->setEnabled(false);
         m_infoButton->setEnabled(false);
+        m_snapshotButton->setEnabled(false);
     }
 
     metaDataChanged();
@@ -201,18 +344,366 @@ void Player::setCustomAudioRole(const QString &role)
     m_player->setCustomAudioRole(role);
 }
 
+// Routes the active player's signals to the UI and the UI's commands to it.
+// Everything here is undone by disconnectPlayer() when players are swapped.
+void Player::connectPlayer(QMediaPlayer *player)
+{
+    player->setNotifyInterval(m_notifyInterval);
+    m_analysisPresenter->setPlayer(player);
+
+    connect(player, &QMediaPlayer::durationChanged, this, &Player::durationChanged);
+    connect(player, &QMediaPlayer::positionChanged, this, &Player::positionChanged);
+    connect(player, QOverload<>::of(&QMediaPlayer::metaDataChanged), this, &Player::metaDataChanged);
+    connect(player, &QMediaPlayer::mediaStatusChanged, this, &Player::statusChanged);
+    connect(player, &QMediaPlayer::videoAvailableChanged, this, &Player::videoAvailableChanged);
+    connect(player, QOverload<QMediaPlayer::Error>::of(&QMediaPlayer::error), this, &Player::displayErrorMessage);
+    connect(player, &QMediaPlayer::stateChanged, this, &Player::stateChanged);
+    connect(player, &QMediaPlayer::playbackRateChanged, this, &Player::updateTimeStretch);
+
+    connect(m_controls, &PlayerControls::play, player, &QMediaPlayer::play);
+    connect(m_controls, &PlayerControls::pause, player, &QMediaPlayer::pause);
+    connect(m_controls, &PlayerControls::stop, player, &QMediaPlayer::stop);
+    connect(m_controls, &PlayerControls::changeVolume, player, &QMediaPlayer::setVolume);
+    connect(m_controls, &PlayerControls::changeRate, player, &QMediaPlayer::setPlaybackRate);
+
+    PlayerControls *controls = m_controls;
+    connect(player, &QMediaPlayer::stateChanged, controls, &PlayerControls::setState);
+    connect(player, &QMediaPlayer::volumeChanged, controls, &PlayerControls::setVolume);
+    connect(player, &QMediaPlayer::mutedChanged, controls, [this, controls](bool muted) {
+        if (!m_timeStretch->isActive())
+            controls->setMuted(muted);
+    });
+    connect(player, &QMediaPlayer::playbackRateChanged, controls, [controls](qreal rate) {
+        controls->setPlaybackRate(float(rate));
+    });
+
+    if (m_session)
+        connectSession(player);
+
+    updateTimeStretch();
+    updateProbeSources();
+    m_seekController->setPlayer(player);
+}
+
+void Player::disconnectPlayer(QMediaPlayer *player)
+{
+    disconnect(player, nullptr, this, nullptr);
+    disconnect(player, nullptr, m_controls, nullptr);
+    disconnect(m_controls, nullptr, player, nullptr);
+    if (m_session)
+        disconnect(player, nullptr, m_session, nullptr);
+}
+
+void Player::connectSession(QMediaPlayer *player)
+{
+    connect(player, &QMediaPlayer::positionChanged, m_session, &SessionStore::setPosition);
+    connect(player, &QMediaPlayer::playbackRateChanged, m_session, &SessionStore::setPlaybackRate);
+    connect(player, &QMediaPlayer::volumeChanged, m_session, &SessionStore::setVolume);
+}
+
+void Player::setSessionFile(const QString &fileName)
+{
+    delete m_session;
+    m_session = new SessionStore(fileName, this);
+
+    connect(m_playlist, &QMediaPlaylist::mediaInserted, this, &Player::scheduleSessionSync, Qt::UniqueConnection);
+    connect(m_playlist, &QMediaPlaylist::mediaRemoved, this, &Player::scheduleSessionSync, Qt::UniqueConnection);
+    connect(m_playlist, &QMediaPlaylist::mediaChanged, this, &Player::scheduleSessionSync, Qt::UniqueConnection);
+    connect(m_playlist, &QMediaPlaylist::currentIndexChanged, m_session, &SessionStore::setCurrentIndex);
+    connectSession(m_player);
+}
+
+void Player::setNotifyInterval(int msecs)
+{
+    m_notifyInterval = msecs;
+    m_player->setNotifyInterval(msecs);
+}
+
+void Player::setPreloadInterval(int seconds)
+{
+    m_preloadInterval = qMax(0, seconds);
+    setStandbyEnabled(m_preloadInterval > 0 || isLooping());
+}
+
+// With a standby player the playlist is driven by hand, so the next item or
+// the loop start can be opened in the standby ahead of time. Switching
+// reopens the current media; playback continues where it was.
+void Player::setStandbyEnabled(bool enable)
+{
+    if (enable == bool(m_standbyPlayer))
+        return;
+
+    const qint64 position = m_player->position();
+    const bool play = m_player->state() == QMediaPlayer::PlayingState;
+
+    if (enable) {
+        m_standbyPlayer = new QMediaPlayer(this);
+        m_standbyPlayer->setAudioRole(m_player->audioRole());
+        m_standbyPlayer->setCustomAudioRole(m_player->customAudioRole());
+        m_player->setPlaylist(nullptr);
+        connect(m_playlist, &QMediaPlaylist::currentIndexChanged, this, &Player::loadCurrentMedia);
+        m_player->setMedia(m_playlist->currentMedia());
+    } else {
+        disconnect(m_playlist, &QMediaPlaylist::currentIndexChanged, this, &Player::loadCurrentMedia);
+        releaseStandby();
+        delete m_standbyPlayer;
+        m_standbyPlayer = nullptr;
+        m_player->setPlaylist(m_playlist);
+    }
+
+    if (position > 0)
+        m_player->setPosition(position);
+    if (play)
+        m_player->play();
+}
+
+void Player::loadCurrentMedia()
+{
+    const int index = m_playlist->currentIndex();
+    const bool play = m_advancing || m_player->state() == QMediaPlayer::PlayingState;
+    m_advancing = false;
+
+    if (index >= 0 && index == m_standbyIndex) {
+        swapToStandby(play);
+        return;
+    }
+
+    releaseStandby();
+    m_player->setMedia(m_playlist->currentMedia());
+    if (play)
+        m_player->play();
+}
+
+void Player::prepareStandby(int index)
+{
+    m_standbyIndex = index;
+    m_standbyPlayer->setVolume(m_player->volume());
+    m_standbyPlayer->setMuted(m_player->isMuted());
+    m_standbyPlayer->setPlaybackRate(m_player->playbackRate());
+    m_standbyPlayer->setMedia(m_playlist->media(index));
+    // Pausing prerolls the pipeline without producing any output.
+    m_standbyPlayer->pause();
+}
+
+void Player::releaseStandby()
+{
+    if (m_standbyIndex < 0 && !m_standbyLooping)
+        return;
+
+    m_standbyIndex = -1;
+    m_standbyLooping = false;
+    m_standbyPlayer->stop();
+    m_standbyPlayer->setMedia(QMediaContent());
+}
+
+void Player::swapToStandby(bool play)
+{
+    QMediaPlayer *previous = m_player;
+
+    disconnectPlayer(previous);
+    previous->setVideoOutput(static_cast<QVideoWidget *>(nullptr));
+
+    m_player = m_standbyPlayer;
+    m_standbyPlayer = previous;
+    m_standbyIndex = -1;
+
+    m_player->setVideoOutput(m_videoWidget);
+    connectPlayer(m_player);
+
+    if (m_standbyLooping) {
+        m_player->setVolume(previous->volume());
+        m_player->setMuted(previous->isMuted());
+        m_player->setPlaybackRate(previous->playbackRate());
+        if (play)
+            m_player->play();
+
+        // The previous player waits at the loop start for the next cycle.
+        previous->pause();
+        previous->setPosition(m_loopStart);
+        m_controls->setState(m_player->state());
+        return;
+    }
+
+    if (play)
+        m_player->play();
+
+    previous->stop();
+    previous->setMedia(QMediaContent());
+
+    // The new player already has its media, so nothing below re-announces it.
+    durationChanged(m_player->duration());
+    statusChanged(m_player->mediaStatus());
+    videoAvailableChanged(m_player->isVideoAvailable());
+    metaDataChanged();
+    m_controls->setState(m_player->state());
+}
+
+void Player::preloadNext(qint64 position)
+{
+    if (!m_standbyPlayer || m_preloadInterval <= 0 || m_standbyIndex >= 0 || isLooping())
+        return;
+
+    const qint64 duration = m_player->duration();
+    if (duration <= 0 || duration - position > m_preloadInterval * 1000)
+        return;
+
+    const int next = m_playlist->nextIndex();
+    if (next >= 0)
+        prepareStandby(next);
+}
+
+bool Player::restoreSession()
+{
+    if (!m_session || !m_session->load())
+        return false;
+
+    const QVector<SessionStore::Entry> entries = m_session->entries();
+    if (entries.isEmpty())
+        return false;
+
+    m_restoringSession = true;
+
+    // Seed the cached durations and titles first so nothing gets probed again.
+    QList<QMediaContent> media;
+    media.reserve(entries.size());
+    for (const SessionStore::Entry &entry : entries) {
+        QVariantMap tags;
+        if (!entry.title.isEmpty())
+            tags.insert(QMediaMetaData::Title, entry.title);
+        m_playlistModel->setMediaInfo(entry.url, entry.duration, tags);
+        media.append(QMediaContent(entry.url));
+    }
+    m_playlist->addMedia(media);
+
+    const int currentIndex = m_session->currentIndex();
+    m_player->setVolume(m_session->volume());
+    m_player->setPlaybackRate(m_session->playbackRate());
+    if (currentIndex >= 0 && currentIndex < entries.size()) {
+        m_pendingPosition = m_session->position();
+        m_playlist->setCurrentIndex(currentIndex);
+    }
+
+    m_restoringSession = false;
+    return true;
+}
+
+void Player::scheduleSessionSync()
+{
+    if (m_restoringSession || m_sessionSyncPending)
+        return;
+
+    m_sessionSyncPending = true;
+    QTimer::singleShot(0, this, &Player::syncSessionPlaylist);
+}
+
+void Player::syncSessionPlaylist()
+{
+    m_sessionSyncPending = false;
+
+    QVector<SessionStore::Entry> entries;
+    entries.reserve(m_playlistModel->rowCount());
+    for (int row = 0; row < m_playlistModel->rowCount(); ++row) {
+        SessionStore::Entry entry;
+        entry.url = m_playlistModel->url(row);
+        entry.title = m_playlistModel->tags(row).value(QMediaMetaData::Title).toString();
+        entry.duration = m_playlistModel->duration(row);
+        entries.append(entry);
+    }
+    m_session->setEntries(entries);
+    m_session->setCurrentIndex(m_playlist->currentIndex());
+}
+
+void Player::updateCurrentMediaInfo()
+{
+    const QUrl url = m_player->currentMedia().canonicalUrl();
+    if (url.isEmpty())
+        return;
+
+    QVariantMap tags;
+    if (m_player->isMetaDataAvailable()) {
+        for (const QString &key : m_player->availableMetaData())
+            tags.insert(key, m_player->metaData(key));
+    }
+    m_playlistModel->setMediaInfo(url, m_player->duration(), tags);
+
+    if (m_session)
+        m_session->setMediaInfo(url, tags.value(QMediaMetaData::Title).toString(), m_player->duration());
+}
+
+void Player::enqueueProbes(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    QList<QUrl> urls;
+    for (int row = first; row <= last; ++row) {
+        const QUrl url = m_playlistModel->url(row);
+        if (!m_playlistModel->hasMediaInfo(url))
+            urls.append(url);
+    }
+    m_probePool->enqueue(urls);
+    m_visibleProbeTimer->start();
+}
+
+void Player::prioritizeVisibleProbes()
+{
+    const QModelIndex first = m_playlistView->indexAt(QPoint(0, 0));
+    if (!first.isValid())
+        return;
+
+    const QModelIndex last = m_playlistView->indexAt(QPoint(0, m_playlistView->viewport()->height() - 1));
+    const int lastRow = last.isValid() ? last.row() : m_playlistModel->rowCount() - 1;
+
+    QList<QUrl> urls;
+    for (int row = first.row(); row <= lastRow; ++row) {
+        const QUrl url = m_playlistModel->url(row);
+        if (!m_playlistModel->hasMediaInfo(url))
+            urls.append(url);
+    }
+    m_probePool->prioritize(urls);
+}
+
+void Player::mediaProbed(const QUrl &url, qint64 duration, const QVariantMap &tags)
+{
+    m_playlistModel->setMediaInfo(url, duration, tags);
+
+    if (m_session)
+        m_session->setMediaInfo(url, tags.value(QMediaMetaData::Title).toString(), duration);
+}
+
+void Player::updatePlaylistDuration()
+{
+    const int count = m_playlistModel->rowCount();
+    QString text = tr("Total: %1").arg(PlaylistModel::formatDuration(m_playlistModel->totalDuration()));
+    if (m_playlistModel->knownDurationCount() < count)
+        text += tr(" (%1 of %2 items)").arg(m_playlistModel->knownDurationCount()).arg(count);
+    m_labelPlaylistDuration->setText(count ? text : QString());
+}
+
 void Player::durationChanged(qint64 duration)
 {
-    m_duration = duration / 1000;
-    m_slider->setMaximum(m_duration);
+    if (!m_loopUrl.isEmpty() && m_loopUrl != m_player->currentMedia().canonicalUrl())
+        clearLoop();
+
+    m_slider->setMaximum(int(duration));
+    m_positionPresenter->setDuration(duration);
+    m_thumbnails->setMedia(m_player->currentMedia().canonicalUrl(), duration);
+    m_analysisCache->setMedia(m_player->currentMedia().canonicalUrl(), duration);
+    m_frameExporter->setBaseName(QFileInfo(m_player->currentMedia().canonicalUrl().fileName()).completeBaseName());
+    m_frameExporter->clearLastFrame();
+
+    updateCurrentMediaInfo();
 }
 
 void Player::positionChanged(qint64 progress)
 {
-    if (!m_slider->isSliderDown())
-        m_slider->setValue(progress / 1000);
+    preloadNext(progress);
+    scheduleLoopBack(progress);
 
-    updateDurationInfo(progress / 1000);
+    if (!m_slider->isSliderDown() && !m_seekController->isSeeking())
+        m_slider->setValue(int(progress));
+    m_overview->setPosition(progress);
+
+    m_positionPresenter->setPosition(progress);
 }
 
 void Player::metaDataChanged()
@@ -229,6 +720,10 @@ void Player::metaDataChanged()
                     ? QPixmap(url.toString())
                     : QPixmap());
         }
+
+        m_seekController->setFrameRate(m_player->metaData(QMediaMetaData::VideoFrameRate).toReal());
+
+        updateCurrentMediaInfo();
     }
 }
 
@@ -256,15 +751,61 @@ void Player::playlistPositionChanged(int currentItem)
     m_playlistView->setCurrentIndex(m_playlistModel->index(currentItem, 0));
 }
 
-void Player::seek(int seconds)
+void Player::seek(int position)
 {
-    m_player->setPosition(seconds * 1000);
+    m_seekController->seek(position);
+}
+
+bool Player::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_slider) {
+        if (event->type() == QEvent::MouseMove)
+            showThumbnailPreview(static_cast<QMouseEvent *>(event)->pos().x());
+        else if (event->type() == QEvent::Leave || event->type() == QEvent::Hide)
+            m_thumbnailPreview->hide();
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void Player::showThumbnailPreview(int x)
+{
+    if (m_slider->maximum() <= m_slider->minimum()) {
+        m_thumbnailPreview->hide();
+        return;
+    }
+
+    int value = QStyle::sliderValueFromPosition(m_slider->minimum(), m_slider->maximum(), x, m_slider->width());
+    m_previewPosition = value;
+    m_previewX = x;
+
+    QImage image = m_thumbnails->thumbnail(m_previewPosition);
+    if (image.isNull())
+        m_thumbnailPreview->setText(PlaylistModel::formatDuration(m_previewPosition));
+    else
+        m_thumbnailPreview->setPixmap(QPixmap::fromImage(image));
+    m_thumbnailPreview->adjustSize();
+
+    QPoint topLeft(x - m_thumbnailPreview->width() / 2, -m_thumbnailPreview->height() - 4);
+    m_thumbnailPreview->move(m_slider->mapToGlobal(topLeft));
+    m_thumbnailPreview->show();
+}
+
+void Player::thumbnailReady(int slot)
+{
+    if (m_thumbnailPreview->isVisible() && slot == m_thumbnails->slotAt(m_previewPosition))
+        showThumbnailPreview(m_previewX);
 }
 
 void Player::statusChanged(QMediaPlayer::MediaStatus status)
 {
     handleCursor(status);
 
+    if (m_pendingPosition >= 0
+            && (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia)) {
+        m_player->setPosition(m_pendingPosition);
+        m_pendingPosition = -1;
+    }
+
     // handle status message
     switch (status) {
     case QMediaPlayer::UnknownMediaStatus:
@@ -285,6 +826,14 @@ void Player::statusChanged(QMediaPlayer::MediaStatus status)
         setStatusInfo(tr("Stalled %1%").arg(m_player->bufferStatus()));
         break;
     case QMediaPlayer::EndOfMedia:
+        if (m_standbyPlayer) {
+            const int next = m_standbyIndex >= 0 ? m_standbyIndex : m_playlist->nextIndex();
+            if (next >= 0) {
+                m_advancing = true;
+                m_playlist->setCurrentIndex(next);
+                break;
+            }
+        }
         QApplication::alert(this);
         break;
     case QMediaPlayer::InvalidMedia:
@@ -297,6 +846,153 @@ void Player::stateChanged(QMediaPlayer::State state)
 {
     if (state == QMediaPlayer::StoppedState)
         clearHistogram();
+    updateTimeStretch();
+}
+
+bool Player::isLooping() const
+{
+    return m_loopStart >= 0 && m_loopEnd > m_loopStart;
+}
+
+void Player::markLoopStart()
+{
+    m_loopStart = m_seekController->targetPosition();
+    if (m_loopEnd >= 0 && m_loopEnd <= m_loopStart + MinLoopDuration)
+        m_loopEnd = -1;
+    m_loopUrl = m_player->currentMedia().canonicalUrl();
+    updateLoop();
+}
+
+void Player::markLoopEnd()
+{
+    const qint64 position = m_seekController->targetPosition();
+    if (m_loopStart < 0)
+        m_loopStart = 0;
+    if (position <= m_loopStart + MinLoopDuration) {
+        showMessage(tr("The loop end has to be after the loop start"), 3000);
+        updateLoop();
+        return;
+    }
+
+    m_loopEnd = position;
+    m_loopUrl = m_player->currentMedia().canonicalUrl();
+    updateLoop();
+    if (m_player->state() == QMediaPlayer::PlayingState)
+        loopBack();
+}
+
+void Player::clearLoop()
+{
+    m_loopStart = -1;
+    m_loopEnd = -1;
+    m_loopUrl.clear();
+    m_loopTimer->stop();
+    if (m_standbyLooping)
+        releaseStandby();
+    // A standby created only for the loop goes with it, outside of the
+    // player signal that may have got us here.
+    QTimer::singleShot(0, this, [this]() {
+        if (m_preloadInterval <= 0 && !isLooping())
+            setStandbyEnabled(false);
+    });
+    updateLoop();
+}
+
+void Player::updateLoop()
+{
+    m_controls->setLoopRange(m_loopStart, m_loopEnd);
+    m_overview->setLoopRange(m_loopStart, m_loopEnd);
+    m_loopTimer->stop();
+    if (isLooping())
+        prepareLoopStandby();
+}
+
+// The loop start is prefetched: a standby player (created for the loop
+// unless --preload keeps one anyway) opens the same media paused at the loop
+// start, and the players are swapped at the loop end instead of seeking back.
+void Player::prepareLoopStandby()
+{
+    setStandbyEnabled(true);
+
+    if (m_standbyIndex >= 0)
+        releaseStandby();
+
+    m_standbyLooping = true;
+    m_standbyPlayer->setVolume(m_player->volume());
+    m_standbyPlayer->setMuted(m_player->isMuted());
+    m_standbyPlayer->setPlaybackRate(m_player->playbackRate());
+    if (m_standbyPlayer->currentMedia() != m_player->currentMedia())
+        m_standbyPlayer->setMedia(m_player->currentMedia());
+    m_standbyPlayer->pause();
+    m_standbyPlayer->setPosition(m_loopStart);
+}
+
+// The position is only reported every notify interval, so the jump back is
+// timed from the last report.
+void Player::scheduleLoopBack(qint64 position)
+{
+    if (!isLooping() || m_player->state() != QMediaPlayer::PlayingState || m_seekController->isSeeking())
+        return;
+
+    if (position >= m_loopEnd) {
+        loopBack();
+        return;
+    }
+
+    const qreal rate = m_player->playbackRate() > 0 ? m_player->playbackRate() : 1.0;
+    const qint64 remaining = qint64((m_loopEnd - position) / rate);
+    if (remaining <= m_notifyInterval + 100)
+        m_loopTimer->start(int(remaining));
+}
+
+void Player::loopBack()
+{
+    m_loopTimer->stop();
+    if (!isLooping())
+        return;
+
+    switch (m_standbyLooping ? m_standbyPlayer->mediaStatus() : QMediaPlayer::UnknownMediaStatus) {
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferedMedia:
+        swapToStandby(m_player->state() == QMediaPlayer::PlayingState);
+        break;
+    default:
+        m_seekController->seekNow(m_loopStart);
+        break;
+    }
+}
+
+void Player::setMuted(bool muted)
+{
+    m_timeStretch->setMuted(muted);
+    m_player->setMuted(muted || m_timeStretch->isActive());
+    if (m_timeStretch->isActive())
+        m_controls->setMuted(muted);
+}
+
+void Player::setPitchCorrection(bool enabled)
+{
+    m_pitchCorrection = enabled;
+    m_controls->setPitchCorrected(enabled);
+    updateTimeStretch();
+}
+
+// Backends shift the pitch along with the rate. With pitch correction the
+// player is muted while playing at another rate and the probed audio goes
+// through the time stretch instead.
+void Player::updateTimeStretch()
+{
+    const qreal rate = m_player->playbackRate();
+    const bool active = m_pitchCorrection && m_player->state() == QMediaPlayer::PlayingState
+            && rate > 0 && qAbs(rate - 1.0) > 0.01;
+
+    m_timeStretch->setRate(rate);
+    if (active == m_timeStretch->isActive())
+        return;
+
+    m_timeStretch->setActive(active);
+    m_player->setMuted(active || m_controls->isMuted());
+    updateProbeSources();
 }
 
 void Player::handleCursor(QMediaPlayer::MediaStatus status)
@@ -327,6 +1023,7 @@ void Player::videoAvailableChanged(bool available)
     m_fullScreenButton->setEnabled(available);
     m_colorButton->setEnabled(available);
     m_infoButton->setEnabled(available);
+    m_snapshotButton->setEnabled(available);
 }
 
 void Player::setTrackInfo(const QString &info)
@@ -337,6 +1034,12 @@ void Player::setTrackInfo(const QString &info)
                    .arg(m_player->metaData("Title").toString()));
 }
 
+void Player::showMessage(const QString &message, int msecs)
+{
+    m_messageLabel->setText(message);
+    m_messageTimer->start(msecs);
+}
+
 void Player::setStatusInfo(const QString &info)
 {
     m_statusInfo = info;
@@ -350,22 +1053,6 @@ void Player::displayErrorMessage()
     setStatusInfo(m_player->errorString());
 }
 
-void Player::updateDurationInfo(qint64 currentInfo)
-{
-    QString tStr;
-    if (currentInfo || m_duration) {
-        QTime currentTime((currentInfo / 3600) % 60, (currentInfo / 60) % 60,
-            currentInfo % 60, (currentInfo * 1000) % 1000);
-        QTime totalTime((m_duration / 3600) % 60, (m_duration / 60) % 60,
-            m_duration % 60, (m_duration * 1000) % 1000);
-        QString format = "mm:ss";
-        if (m_duration > 3600)
-            format = "hh:mm:ss";
-        tStr = currentTime.toString(format) + " / " + totalTime.toString(format);
-    }
-    m_labelDuration->setText(tStr);
-}
-
 void Player::showColorDialog()
 {
     QSlider *brightnessSlider = new QSlider(Qt::Horizontal);
@@ -414,10 +1101,9 @@ void Player::showInfoDialog()
 {
     QFormLayout *layout = new QFormLayout;
     m_pTableWidget = new QTableWidget(this);
-    QFile file(QString("DataQt.txt"));
     QVariant var_data;
     int rowTotalHeight = 0;
-    bool inBase = false;
+    QStringList videoProps;
 
     m_pTableWidget->setRowCount(metadata.count());
     m_pTableWidget->setColumnCount(2);
@@ -425,58 +1111,24 @@ void Player::showInfoDialog()
     m_pTableWidget->setHorizontalHeaderLabels(m_TableHeader);
     m_pTableWidget->setShowGrid(true);
 
-    if (file.exists()) {
-        if (file.open(QIODevice::ReadOnly)) {
-            QTextStream stream (&file);
-            QString line = "";
-            QString property;
-            QStringList videoList;
-            QStringList videoProps;
-            int count;
-
-            while(!stream.atEnd()) {
-                line += stream.readLine();
-            }
-            videoList = line.split("/");
-
-            //get title
-            property = m_player->metaData(metadata[0]).toString();
-            count =  videoList.count() - 1;
-
-            for (int k = 0; k < count && !inBase; k++) {
-                videoProps = videoList.at(k).split(";");
-                if (property == videoProps.at(0)) {
-                    inBase = true;
-                }
-            }
-
-            for (int row = 0; row < metadata.count(); row++) {
-                m_pTableWidget->setItem(row, 0, new QTableWidgetItem(metadata[row]));
-
-                var_data = videoProps.at(row);
-                m_pTableWidget->setItem(row, 1, new QTableWidgetItem(var_data.toString()));
-
-                rowTotalHeight += m_pTableWidget->verticalHeader()->sectionSize(row);
-            }
+    //get title
+    QString property = m_player->metaData(metadata[0]).toString();
+    bool inBase = m_metadataStore.find(property, &videoProps);
 
+    for (int row = 0; row < metadata.count(); row++) {
+        m_pTableWidget->setItem(row, 0, new QTableWidgetItem(metadata[row]));
 
-            file.close();
-        }
-    }
-
-    if (!inBase) {
-
-        for (int row = 0; row < metadata.count(); row++) {
-            m_pTableWidget->setItem(row, 0, new QTableWidgetItem(metadata[row]));
-
+        if (inBase) {
+            var_data = videoProps.at(row);
+        } else {
             var_data = m_player->metaData(metadata[row]);
             if (var_data.toString().length() == 0) {
                 var_data = "null";
             }
-            m_pTableWidget->setItem(row, 1, new QTableWidgetItem(var_data.toString()));
-
-            rowTotalHeight += m_pTableWidget->verticalHeader()->sectionSize(row);
         }
+        m_pTableWidget->setItem(row, 1, new QTableWidgetItem(var_data.toString()));
+
+        rowTotalHeight += m_pTableWidget->verticalHeader()->sectionSize(row);
     }
 
     rowTotalHeight += m_pTableWidget->horizontalHeader()->height();
@@ -502,128 +1154,155 @@ void Player::showInfoDialog()
 
 void Player::saveChanges()
 {
-    m_infoDialog->children();
+    TRACE_SCOPE("Player::saveChanges");
     QTableWidget* m_pTableWidget = m_infoDialog->findChild<QTableWidget*>();
-    QVariant inputData;
-    QString fileData = "";
-    QFile file(QString("DataQt.txt"));
-    QVariant var_data;
-    QString property;
-
-    file.open(QIODevice::ReadWrite);
-    QTextStream stream(&file);
-
-    QString line = "";
-    QStringList videoList;
     QStringList videoProps;
-    int count;
-    bool inBase;
 
-    while(!stream.atEnd()) {
-        line += stream.readLine();
+    for (int i = 0; i < metadata.count(); i++) {
+        videoProps << m_pTableWidget->item(i,1)->text();
     }
-    videoList = line.split("/");
-
-    count = videoList.count() - 1;
+    m_metadataStore.save(videoProps);
 
-    //get title of video to check if we have it already in database
-    var_data = m_pTableWidget->item(0,1)->text();
-    property = var_data.toString();
+    createHTML();
 
-    inBase = false;
-    for (int k = 0; k < count && !inBase; k++) {
-        videoProps = videoList.at(k).split(";");
+    m_infoDialog->close();
+}
 
-        if (property == videoProps.at(0)) {
-            for (int i = 1; i < metadata.count(); i++) {
-                var_data = m_pTableWidget->item(i,1)->text();
-                videoProps[i] = var_data.toString();
-            }
+void Player::createHTML() {
+    TRACE_SCOPE("Player::createHTML");
+    m_metadataStore.exportHtml();
+}
 
-            inBase = true;
+bool Player::setSceneLogFile(const QString &fileName)
+{
+    delete m_sceneLog;
+    m_sceneLog = new QFile(fileName, this);
+    if (m_sceneLog->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        return true;
+
+    delete m_sceneLog;
+    m_sceneLog = nullptr;
+    return false;
+}
 
-            file.close();
-            file.open(QIODevice::WriteOnly);
-            QTextStream stream(&file);
+void Player::sceneEvent(const SceneEvent &event)
+{
+    showMessage(event.toString(), 3000);
 
-            for (int ii = 0; ii < metadata.count(); ii++) {
-                stream << videoProps.at(ii) << ";";
-            }
-            stream << "/" << endl;
-
-            for (int kk = 0; kk < count; kk++) {
-                if (kk == k) {
-                    continue;
-                }
-                videoProps = videoList.at(kk).split(";");
-                for (int ii = 0; ii < metadata.count(); ii++) {
-                    stream << videoProps.at(ii) << ";";
-                }
-                stream << "/" << endl;
-            }
-        }
+    if (m_sceneLog) {
+        QString line = m_player->currentMedia().canonicalUrl().toString() + '\t' + event.toString() + '\n';
+        m_sceneLog->write(line.toUtf8());
+        m_sceneLog->flush();
     }
+}
 
-    if (!inBase) {
-        for (int i = 0; i < metadata.count(); i++) {
-            var_data = m_pTableWidget->item(i,1)->text();
-            fileData = var_data.toString();
-            stream << fileData << ";";
-        }
-        stream << "/" << endl;
+// Starts recording on first use; afterwards writes what has been recorded.
+void Player::toggleTrace()
+{
+    if (!Tracer::isEnabled()) {
+        Tracer::setEnabled(true);
+        showMessage(tr("Tracing started, press Ctrl+Shift+T again to save"), 5000);
+        return;
     }
 
-    file.close();
+    QString fileName = Tracer::outputFile();
+    if (fileName.isEmpty())
+        fileName = QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
 
-    createHTML();
+    if (Tracer::writeChromeTrace(fileName))
+        showMessage(tr("Trace written to %1").arg(fileName), 5000);
+    else
+        showMessage(tr("Cannot write %1").arg(fileName), 5000);
+}
 
-    m_infoDialog->close();
+qreal Player::overviewScanRate() const
+{
+    return m_analysisCache->scanRate();
 }
 
-void Player::createHTML() {
-    QFile htmlFile(QString("Index.html"));
-    htmlFile.open(QIODevice::WriteOnly);
-    QTextStream htmlStream(&htmlFile);
+void Player::setOverviewScanRate(qreal rate)
+{
+    m_analysisCache->setScanRate(rate);
+}
 
-    QFile dataFile(QString("DataQt.txt"));
-    dataFile.open(QIODevice::ReadOnly);
-    QTextStream dataStream (&dataFile);
+void Player::setLiveAnalysisWhenCached(bool enabled)
+{
+    m_liveAnalysisWhenCached = enabled;
+    updateProbeSources();
+}
 
-    QString line = "";
-    QStringList videoList;
-    QStringList videoProps;
+int Player::maxResultLatency() const
+{
+    return m_analysisPresenter->maxLatency();
+}
 
-    int count;
+void Player::setMaxResultLatency(int msecs)
+{
+    m_analysisPresenter->setMaxLatency(msecs);
+}
 
-    while(!dataStream.atEnd()) {
-        line += dataStream.readLine();
-    }
-    videoList = line.split("/");
-
-    htmlStream << "<!doctypehtml><style>table{font-family:arial,sans-serif;text-align:left;width:100%}td,th{border:1px solid #ddd;padding:8px}"
-                  "tr:nth-child(even){background-color:#ddd}</style><table><tr><th>Title<th>Author<th>Description<th>Genre<th>Year<th>Date<th>"
-                  "UserRating<th>Language<th>Director<th>Writer<th>Copytight<th>Size<th>MediaType<th>Duration";
-    htmlStream << "  <tr>\n";
-
-    count = videoList.count() - 1;
-    for (int k = 0; k < count; k++) {
-        videoProps = videoList.at(k).split(";");
-        for (int i = 0; i < metadata.count(); i++) {
-            htmlStream << "  	<td>";
-            htmlStream << videoProps.at(i);
-            htmlStream << "</td>\n";
-        }
-        htmlStream << "  </tr>\n";
+void Player::setSnapshotDirectory(const QString &directory)
+{
+    m_frameExporter->setDirectory(directory);
+}
+
+bool Player::setSnapshotFormat(const QString &name)
+{
+    FrameExporter::Format format;
+    if (!FrameExporter::formatFromName(name, &format))
+        return false;
+    m_frameExporter->setFormat(format);
+    return true;
+}
+
+void Player::setBurstInterval(int frames)
+{
+    m_burstInterval = qMax(1, frames);
+}
+
+void Player::startBurst()
+{
+    m_frameExporter->startBurst(m_burstInterval);
+    showMessage(tr("Saving one frame in %1, press Shift+S to stop").arg(m_burstInterval), 3000);
+}
+
+// While paused the probe delivers nothing, so the frame on screen is the
+// last one probed.
+void Player::grabFrame()
+{
+    if (m_player->state() == QMediaPlayer::PlayingState || !m_frameExporter->hasLastFrame())
+        m_frameExporter->grabNext();
+    else if (!m_frameExporter->grabLast())
+        showMessage(tr("Still saving the previous frames"), 3000);
+}
+
+void Player::toggleBurst()
+{
+    if (m_frameExporter->isBursting()) {
+        m_frameExporter->stopBurst();
+        showMessage(tr("Burst capture stopped (%1 frames dropped)").arg(m_frameExporter->droppedFrames()), 3000);
+    } else {
+        startBurst();
     }
+}
 
-    htmlStream << "</table>";
+// Media with a complete cached analysis can skip the live analysis.
+void Player::updateProbeSources()
+{
+    // The probes stay attached for the scope, frame export and time stretch;
+    // only the histogram and level analysis is skipped.
+    const bool live = m_liveAnalysisWhenCached || !m_analysisCache->isComplete();
+    if (m_videoHistogram->liveAnalysis() && !live)
+        clearHistogram();
+    m_videoHistogram->setLiveAnalysis(live);
+    m_audioHistogram->setLiveAnalysis(live);
 
-    htmlFile.close();
-    dataFile.close();
+    m_videoProbe->setSource(m_player);
+    m_audioProbe->setSource(m_player);
 }
 
 void Player::clearHistogram()
 {
     QMetaObject::invokeMethod(m_videoHistogram, "processFrame", Qt::QueuedConnection, Q_ARG(QVideoFrame, QVideoFrame()));
     QMetaObject::invokeMethod(m_audioHistogram, "processBuffer", Qt::QueuedConnection, Q_ARG(QAudioBuffer, QAudioBuffer()));
-}
+}
\ No newline at end of file
@@ -9,8 +9,12 @@
 #include <QMediaMetaData>
 #include <QMessageBox>
 
+#include "metadatastore.h"
+#include "sceneanalyzer.h"
+
 QT_BEGIN_NAMESPACE
 class QAbstractItemView;
+class QComboBox;
 class QLabel;
 class QMediaPlayer;
 class QModelIndex;
@@ -18,12 +22,26 @@ class QPushButton;
 class QSlider;
 class QStatusBar;
 class QVideoProbe;
-class QVideoWidget;
 class QAudioProbe;
+class QFile;
+class QTimer;
 QT_END_NAMESPACE
 
 class PlaylistModel;
+class VideoWidget;
 class HistogramWidget;
+class ScopeWidget;
+class SessionStore;
+class MediaProbePool;
+class PlayerControls;
+class ThumbnailCache;
+class AnalysisCache;
+class OverviewWidget;
+class TimeStretchOutput;
+class AnalysisPresenter;
+class FrameExporter;
+class SeekController;
+class PositionPresenter;
 
 class Player : public QWidget
 {
@@ -42,9 +60,41 @@ public:
     void addToPlaylist(const QList<QUrl> &urls);
     void setCustomAudioRole(const QString &role);
 
+    void setSessionFile(const QString &fileName);
+    bool restoreSession();
+
+    int notifyInterval() const { return m_notifyInterval; }
+    void setNotifyInterval(int msecs);
+
+    int preloadInterval() const { return m_preloadInterval; }
+    void setPreloadInterval(int seconds);
+
+    bool setSceneLogFile(const QString &fileName);
+
+    qreal overviewScanRate() const;
+    void setOverviewScanRate(qreal rate);
+
+    bool pitchCorrection() const { return m_pitchCorrection; }
+    void setPitchCorrection(bool enabled);
+
+    bool liveAnalysisWhenCached() const { return m_liveAnalysisWhenCached; }
+    void setLiveAnalysisWhenCached(bool enabled);
+
+    int maxResultLatency() const;
+    void setMaxResultLatency(int msecs);
+
+    void setSnapshotDirectory(const QString &directory);
+    bool setSnapshotFormat(const QString &name);
+    int burstInterval() const { return m_burstInterval; }
+    void setBurstInterval(int frames);
+    void startBurst();
+
 signals:
     void fullScreenChanged(bool fullScreen);
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     void open();
     void durationChanged(qint64 duration);
@@ -53,7 +103,7 @@ private slots:
 
     void previousClicked();
 
-    void seek(int seconds);
+    void seek(int position);
     void jump(const QModelIndex &index);
     void playlistPositionChanged(int);
 
@@ -69,45 +119,122 @@ private slots:
     void saveChanges();
     void createHTML();
 
+    void scheduleSessionSync();
+    void syncSessionPlaylist();
+
+    void enqueueProbes(const QModelIndex &parent, int first, int last);
+    void prioritizeVisibleProbes();
+    void mediaProbed(const QUrl &url, qint64 duration, const QVariantMap &tags);
+    void updatePlaylistDuration();
+
+    void loadCurrentMedia();
+    void thumbnailReady(int slot);
+    void toggleTrace();
+    void sceneEvent(const SceneEvent &event);
+    void updateProbeSources();
+    void setMuted(bool muted);
+    void updateTimeStretch();
+    void markLoopStart();
+    void markLoopEnd();
+    void clearLoop();
+    void loopBack();
+    void grabFrame();
+    void toggleBurst();
+
 private:
+    void connectPlayer(QMediaPlayer *player);
+    void disconnectPlayer(QMediaPlayer *player);
+    void connectSession(QMediaPlayer *player);
+    void setStandbyEnabled(bool enable);
+    void prepareStandby(int index);
+    void releaseStandby();
+    void swapToStandby(bool play);
+    void preloadNext(qint64 position);
+    bool isLooping() const;
+    void updateLoop();
+    void prepareLoopStandby();
+    void scheduleLoopBack(qint64 position);
+    void showThumbnailPreview(int x);
     void clearHistogram();
     void setTrackInfo(const QString &info);
     void setStatusInfo(const QString &info);
+    void showMessage(const QString &message, int msecs);
     void handleCursor(QMediaPlayer::MediaStatus status);
-    void updateDurationInfo(qint64 currentInfo);
+    void updateCurrentMediaInfo();
 
 
     QMediaPlayer *m_player = nullptr;
     QMediaPlaylist *m_playlist = nullptr;
-    QVideoWidget *m_videoWidget = nullptr;
+    QMediaPlayer *m_standbyPlayer = nullptr;
+    PlayerControls *m_controls = nullptr;
+    VideoWidget *m_videoWidget = nullptr;
     QLabel *m_coverLabel = nullptr;
     QSlider *m_slider = nullptr;
+    SeekController *m_seekController = nullptr;
     QLabel *m_labelDuration = nullptr;
+    PositionPresenter *m_positionPresenter = nullptr;
+    QLabel *m_thumbnailPreview = nullptr;
+    ThumbnailCache *m_thumbnails = nullptr;
+    AnalysisCache *m_analysisCache = nullptr;
+    OverviewWidget *m_overview = nullptr;
+    TimeStretchOutput *m_timeStretch = nullptr;
+    bool m_pitchCorrection = false;
+    bool m_liveAnalysisWhenCached = true;
+    qint64 m_previewPosition = -1;
+    int m_previewX = 0;
     QPushButton *m_fullScreenButton = nullptr;
     QPushButton *m_colorButton = nullptr;
     QPushButton *m_infoButton = nullptr;
+    QPushButton *m_snapshotButton = nullptr;
     QDialog *m_colorDialog = nullptr;
     QDialog *m_infoDialog = nullptr;
     QLabel *m_statusLabel = nullptr;
     QStatusBar *m_statusBar = nullptr;
+    QLabel *m_messageLabel = nullptr;
+    QTimer *m_messageTimer = nullptr;
 
 
     QTableWidget* m_pTableWidget;
     QStringList m_TableHeader;
+    MetadataStore m_metadataStore;
 
     QLabel *m_labelHistogram = nullptr;
     HistogramWidget *m_videoHistogram = nullptr;
     HistogramWidget *m_audioHistogram = nullptr;
+    QComboBox *m_histogramMode = nullptr;
+    QComboBox *m_scopeSelector = nullptr;
+    ScopeWidget *m_scopeWidget = nullptr;
+    AnalysisPresenter *m_analysisPresenter = nullptr;
+    FrameExporter *m_frameExporter = nullptr;
+    int m_burstInterval = 10;
     QVideoProbe *m_videoProbe = nullptr;
     QAudioProbe *m_audioProbe = nullptr;
 
     PlaylistModel *m_playlistModel = nullptr;
     QAbstractItemView *m_playlistView = nullptr;
+    QLabel *m_labelPlaylistDuration = nullptr;
+    MediaProbePool *m_probePool = nullptr;
+    QTimer *m_visibleProbeTimer = nullptr;
     QString m_trackInfo;
     QString m_statusInfo;
-    qint64 m_duration;
-};
+    int m_notifyInterval = 1000;
+
+    SessionStore *m_session = nullptr;
+    qint64 m_pendingPosition = -1;
+    bool m_sessionSyncPending = false;
+    bool m_restoringSession = false;
 
-#endif // PLAYER_H
+    int m_preloadInterval = 0;
+    int m_standbyIndex = -1;
+    bool m_standbyLooping = false;
+    bool m_advancing = false;
 
+    qint64 m_loopStart = -1;
+    qint64 m_loopEnd = -1;
+    QUrl m_loopUrl;
+    QTimer *m_loopTimer = nullptr;
+
+    QFile *m_sceneLog = nullptr;
+};
 
+#endif // PLAYER_H
\ No newline at end of file
@@ -12,13 +12,65 @@ HEADERS = \
     playercontrols.h \
     playlistmodel.h \
     videowidget.h \
-    histogramwidget.h
+    histogramwidget.h \
+    sessionstore.h \
+    mediaprobepool.h \
+    mediafingerprint.h \
+    videoframesurface.h \
+    thumbnailcache.h \
+    seekcontroller.h \
+    positionpresenter.h \
+    frameanalysis.h \
+    histogramkernels.h \
+    histogramaccumulator.h \
+    analysiswriter.h \
+    analysisjob.h \
+    batchscheduler.h \
+    perfcounters.h \
+    tracer.h \
+    metadatastore.h \
+    sceneanalyzer.h \
+    scopewidget.h \
+    videoframeview.h \
+    analysiscache.h \
+    overviewwidget.h \
+    timestretch.h \
+    monitorwall.h \
+    analysisexecutor.h \
+    analysispresenter.h \
+    frameexporter.h
 SOURCES = main.cpp \
     player.cpp \
     playercontrols.cpp \
     playlistmodel.cpp \
     videowidget.cpp \
-    histogramwidget.cpp
+    histogramwidget.cpp \
+    sessionstore.cpp \
+    mediaprobepool.cpp \
+    mediafingerprint.cpp \
+    videoframesurface.cpp \
+    thumbnailcache.cpp \
+    seekcontroller.cpp \
+    positionpresenter.cpp \
+    frameanalysis.cpp \
+    histogramkernels.cpp \
+    histogramaccumulator.cpp \
+    analysiswriter.cpp \
+    analysisjob.cpp \
+    batchscheduler.cpp \
+    perfcounters.cpp \
+    tracer.cpp \
+    metadatastore.cpp \
+    sceneanalyzer.cpp \
+    scopewidget.cpp \
+    videoframeview.cpp \
+    analysiscache.cpp \
+    overviewwidget.cpp \
+    timestretch.cpp \
+    monitorwall.cpp \
+    analysisexecutor.cpp \
+    analysispresenter.cpp \
+    frameexporter.cpp
 
 target.path = $$[QT_INSTALL_EXAMPLES]/multimediawidgets/player
 INSTALLS += target
\ No newline at end of file
@@ -4,7 +4,8 @@
 #include <QSlider>
 #include <QStyle>
 #include <QToolButton>
-#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QSignalBlocker>
 #include <QAudio>
 
 PlayerControls::PlayerControls(QWidget *parent)
@@ -31,6 +32,38 @@ PlayerControls::PlayerControls(QWidget *parent)
 
     connect(m_previousButton, &QAbstractButton::clicked, this, &PlayerControls::previous);
 
+    m_frameBackButton = new QToolButton(this);
+    m_frameBackButton->setIcon(style()->standardIcon(QStyle::SP_MediaSeekBackward));
+    m_frameBackButton->setToolTip(tr("Previous frame"));
+    m_frameBackButton->setAutoRepeat(true);
+
+    connect(m_frameBackButton, &QAbstractButton::clicked, this, [this]() { emit stepFrame(-1); });
+
+    m_frameForwardButton = new QToolButton(this);
+    m_frameForwardButton->setIcon(style()->standardIcon(QStyle::SP_MediaSeekForward));
+    m_frameForwardButton->setToolTip(tr("Next frame"));
+    m_frameForwardButton->setAutoRepeat(true);
+
+    connect(m_frameForwardButton, &QAbstractButton::clicked, this, [this]() { emit stepFrame(1); });
+
+    m_loopStartButton = new QToolButton(this);
+    m_loopStartButton->setText("A");
+    m_loopStartButton->setCheckable(true);
+
+    connect(m_loopStartButton, &QAbstractButton::clicked, this, &PlayerControls::markLoopStart);
+
+    m_loopEndButton = new QToolButton(this);
+    m_loopEndButton->setText("B");
+    m_loopEndButton->setCheckable(true);
+
+    connect(m_loopEndButton, &QAbstractButton::clicked, this, &PlayerControls::markLoopEnd);
+
+    m_loopClearButton = new QToolButton(this);
+    m_loopClearButton->setText(tr("No loop"));
+
+    connect(m_loopClearButton, &QAbstractButton::clicked, this, &PlayerControls::clearLoop);
+    setLoopRange(-1, -1);
+
     m_muteButton = new QToolButton(this);
     m_muteButton->setIcon(style()->standardIcon(QStyle::SP_MediaVolume));
 
@@ -41,13 +74,23 @@ PlayerControls::PlayerControls(QWidget *parent)
 
     connect(m_volumeSlider, &QSlider::valueChanged, this, &PlayerControls::onVolumeSliderValueChanged);
 
-    m_rateBox = new QComboBox(this);
-    m_rateBox->addItem("0.5x", QVariant(0.5));
-    m_rateBox->addItem("1.0x", QVariant(1.0));
-    m_rateBox->addItem("2.0x", QVariant(2.0));
-    m_rateBox->setCurrentIndex(1);
+    m_rateBox = new QDoubleSpinBox(this);
+    m_rateBox->setRange(0.25, 4.0);
+    m_rateBox->setDecimals(2);
+    m_rateBox->setSingleStep(0.25);
+    m_rateBox->setSuffix("x");
+    m_rateBox->setValue(1.0);
+    m_rateBox->setKeyboardTracking(false);
+    m_rateBox->setAccelerated(true);
+
+    connect(m_rateBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &PlayerControls::updateRate);
 
-    connect(m_rateBox, QOverload<int>::of(&QComboBox::activated), this, &PlayerControls::updateRate);
+    m_pitchButton = new QToolButton(this);
+    m_pitchButton->setText(tr("Keep pitch"));
+    m_pitchButton->setToolTip(tr("Time-stretch the audio so it keeps its pitch at other rates"));
+    m_pitchButton->setCheckable(true);
+
+    connect(m_pitchButton, &QAbstractButton::toggled, this, &PlayerControls::changePitchCorrection);
 
     QBoxLayout *layout = new QHBoxLayout;
     layout->setMargin(0);
@@ -55,9 +98,15 @@ PlayerControls::PlayerControls(QWidget *parent)
     layout->addWidget(m_previousButton);
     layout->addWidget(m_playButton);
     layout->addWidget(m_nextButton);
+    layout->addWidget(m_frameBackButton);
+    layout->addWidget(m_frameForwardButton);
+    layout->addWidget(m_loopStartButton);
+    layout->addWidget(m_loopEndButton);
+    layout->addWidget(m_loopClearButton);
     layout->addWidget(m_muteButton);
     layout->addWidget(m_volumeSlider);
     layout->addWidget(m_rateBox);
+    layout->addWidget(m_pitchButton);
     setLayout(layout);
 }
 
@@ -142,20 +191,39 @@ void PlayerControls::muteClicked()
 
 qreal PlayerControls::playbackRate() const
 {
-    return m_rateBox->itemData(m_rateBox->currentIndex()).toDouble();
+    return m_rateBox->value();
 }
 
 void PlayerControls::setPlaybackRate(float rate)
 {
-    for (int i = 0; i < m_rateBox->count(); ++i) {
-        if (qFuzzyCompare(rate, float(m_rateBox->itemData(i).toDouble()))) {
-            m_rateBox->setCurrentIndex(i);
-            return;
-        }
-    }
+    const QSignalBlocker blocker(m_rateBox);
+    m_rateBox->setValue(rate);
+}
 
-    m_rateBox->addItem(QString("%1x").arg(rate), QVariant(rate));
-    m_rateBox->setCurrentIndex(m_rateBox->count() - 1);
+bool PlayerControls::isPitchCorrected() const
+{
+    return m_pitchButton->isChecked();
+}
+
+void PlayerControls::setPitchCorrected(bool corrected)
+{
+    const QSignalBlocker blocker(m_pitchButton);
+    m_pitchButton->setChecked(corrected);
+}
+
+// The A and B buttons show whether their point is set; clicking them always
+// marks the current position again.
+void PlayerControls::setLoopRange(qint64 start, qint64 end)
+{
+    m_loopStartButton->setChecked(start >= 0);
+    m_loopStartButton->setToolTip(start >= 0
+            ? tr("Loop start: %1 s (click to move here)").arg(start / 1000.0, 0, 'f', 3)
+            : tr("Set the loop start here"));
+    m_loopEndButton->setChecked(end >= 0);
+    m_loopEndButton->setToolTip(end >= 0
+            ? tr("Loop end: %1 s (click to move here)").arg(end / 1000.0, 0, 'f', 3)
+            : tr("Set the loop end here"));
+    m_loopClearButton->setEnabled(start >= 0 || end >= 0);
 }
 
 void PlayerControls::updateRate()
@@ -6,7 +6,7 @@
 
 class QAbstractButton;
 class QAbstractSlider;
-class QComboBox;
+class QDoubleSpinBox;
 
 class PlayerControls : public QWidget
 {
@@ -19,12 +19,15 @@ public:
     int volume() const;
     bool isMuted() const;
     qreal playbackRate() const;
+    bool isPitchCorrected() const;
 
 public slots:
     void setState(QMediaPlayer::State state);
     void setVolume(int volume);
     void setMuted(bool muted);
     void setPlaybackRate(float rate);
+    void setPitchCorrected(bool corrected);
+    void setLoopRange(qint64 start, qint64 end);
 
 signals:
     void play();
@@ -32,9 +35,14 @@ signals:
     void stop();
     void next();
     void previous();
+    void stepFrame(int frames);
+    void markLoopStart();
+    void markLoopEnd();
+    void clearLoop();
     void changeVolume(int volume);
     void changeMuting(bool muting);
     void changeRate(qreal rate);
+    void changePitchCorrection(bool corrected);
 
 private slots:
     void playClicked();
@@ -49,9 +57,15 @@ private:
     QAbstractButton *m_stopButton = nullptr;
     QAbstractButton *m_nextButton = nullptr;
     QAbstractButton *m_previousButton = nullptr;
+    QAbstractButton *m_frameBackButton = nullptr;
+    QAbstractButton *m_frameForwardButton = nullptr;
+    QAbstractButton *m_loopStartButton = nullptr;
+    QAbstractButton *m_loopEndButton = nullptr;
+    QAbstractButton *m_loopClearButton = nullptr;
     QAbstractButton *m_muteButton = nullptr;
     QAbstractSlider *m_volumeSlider = nullptr;
-    QComboBox *m_rateBox = nullptr;
+    QDoubleSpinBox *m_rateBox = nullptr;
+    QAbstractButton *m_pitchButton = nullptr;
 };
 
 #endif // PLAYERCONTROLS_H
\ No newline at end of file
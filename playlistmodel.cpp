@@ -3,6 +3,7 @@
 #include <QFileInfo>
 #include <QUrl>
 #include <QMediaPlaylist>
+#include <QMediaMetaData>
 
 PlaylistModel::PlaylistModel(QObject *parent)
     : QAbstractItemModel(parent)
@@ -45,14 +46,34 @@ QVariant PlaylistModel::data(const QModelIndex &index, int role) const
         QVariant value = m_data[index];
         if (!value.isValid() && index.column() == Title) {
             QUrl location = m_playlist->media(index.row()).canonicalUrl();
-            return QFileInfo(location.path()).fileName();
+            QString title = m_mediaInfo.value(location).tags.value(QMediaMetaData::Title).toString();
+            return !title.isEmpty() ? title : QFileInfo(location.path()).fileName();
+        }
+        if (!value.isValid() && index.column() == Duration) {
+            qint64 ms = duration(index.row());
+            return ms > 0 ? formatDuration(ms) : QVariant();
         }
 
         return value;
     }
+    if (index.isValid() && role == Qt::TextAlignmentRole && index.column() == Duration)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
     return QVariant();
 }
 
+QVariant PlaylistModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case Title:
+            return tr("Title");
+        case Duration:
+            return tr("Duration");
+        }
+    }
+    return QAbstractItemModel::headerData(section, orientation, role);
+}
+
 QMediaPlaylist *PlaylistModel::playlist() const
 {
     return m_playlist.data();
@@ -79,6 +100,7 @@ void PlaylistModel::setPlaylist(QMediaPlaylist *playlist)
         connect(m_playlist.data(), &QMediaPlaylist::mediaChanged, this, &PlaylistModel::changeItems);
     }
 
+    recountRows();
     endResetModel();
 }
 
@@ -90,30 +112,130 @@ bool PlaylistModel::setData(const QModelIndex &index, const QVariant &value, int
     return true;
 }
 
+QUrl PlaylistModel::url(int row) const
+{
+    return m_playlist ? m_playlist->media(row).canonicalUrl() : QUrl();
+}
+
+bool PlaylistModel::hasMediaInfo(const QUrl &url) const
+{
+    return m_mediaInfo.value(url).duration > 0;
+}
+
+qint64 PlaylistModel::duration(int row) const
+{
+    return m_mediaInfo.value(url(row)).duration;
+}
+
+QVariantMap PlaylistModel::tags(int row) const
+{
+    return m_mediaInfo.value(url(row)).tags;
+}
+
+void PlaylistModel::setMediaInfo(const QUrl &url, qint64 duration, const QVariantMap &tags)
+{
+    MediaInfo &info = m_mediaInfo[url];
+    bool changed = false;
+
+    if (!tags.isEmpty() && tags != info.tags) {
+        info.tags = tags;
+        changed = true;
+    }
+
+    qint64 oldDuration = info.duration;
+    int rows = m_rowCount.value(url);
+    if (duration > 0 && duration != oldDuration) {
+        info.duration = duration;
+        changed = true;
+
+        if (rows) {
+            m_totalDuration += (duration - oldDuration) * rows;
+            if (oldDuration <= 0)
+                m_knownDurationCount += rows;
+            emit totalDurationChanged(m_totalDuration);
+        }
+    }
+
+    // Rows are not indexed by url; views only repaint what is visible anyway.
+    if (changed && rows)
+        emit dataChanged(index(0, Title), index(rowCount() - 1, ColumnCount - 1));
+}
+
+QString PlaylistModel::formatDuration(qint64 duration)
+{
+    qint64 seconds = duration / 1000;
+    if (seconds >= 3600) {
+        return QString("%1:%2:%3").arg(seconds / 3600)
+                .arg((seconds / 60) % 60, 2, 10, QLatin1Char('0'))
+                .arg(seconds % 60, 2, 10, QLatin1Char('0'));
+    }
+    return QString("%1:%2").arg(seconds / 60, 2, 10, QLatin1Char('0'))
+            .arg(seconds % 60, 2, 10, QLatin1Char('0'));
+}
+
+// Keeps the per-url row counts and the playlist total in step with inserted
+// (sign = 1) or removed (sign = -1) rows.
+void PlaylistModel::addRows(int start, int end, int sign)
+{
+    qint64 oldTotal = m_totalDuration;
+
+    for (int row = start; row <= end; ++row) {
+        QUrl location = url(row);
+        int &count = m_rowCount[location];
+        count += sign;
+        if (count <= 0)
+            m_rowCount.remove(location);
+
+        qint64 ms = m_mediaInfo.value(location).duration;
+        if (ms > 0) {
+            m_totalDuration += sign * ms;
+            m_knownDurationCount += sign;
+        }
+    }
+
+    if (m_totalDuration != oldTotal)
+        emit totalDurationChanged(m_totalDuration);
+}
+
+void PlaylistModel::recountRows()
+{
+    m_rowCount.clear();
+    m_totalDuration = 0;
+    m_knownDurationCount = 0;
+
+    if (m_playlist && m_playlist->mediaCount() > 0)
+        addRows(0, m_playlist->mediaCount() - 1, 1);
+    else
+        emit totalDurationChanged(0);
+}
+
 void PlaylistModel::beginInsertItems(int start, int end)
 {
     m_data.clear();
     beginInsertRows(QModelIndex(), start, end);
 }
 
-void PlaylistModel::endInsertItems()
+void PlaylistModel::endInsertItems(int start, int end)
 {
     endInsertRows();
+    addRows(start, end, 1);
 }
 
 void PlaylistModel::beginRemoveItems(int start, int end)
 {
     m_data.clear();
+    addRows(start, end, -1);
     beginRemoveRows(QModelIndex(), start, end);
 }
 
 void PlaylistModel::endRemoveItems()
 {
-    endInsertRows();
+    endRemoveRows();
 }
 
 void PlaylistModel::changeItems(int start, int end)
 {
     m_data.clear();
-    emit dataChanged(index(start,0), index(end,ColumnCount));
+    recountRows();
+    emit dataChanged(index(start,0), index(end,ColumnCount - 1));
 }
\ No newline at end of file
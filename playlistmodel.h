@@ -2,7 +2,10 @@
 #define PLAYLISTMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QScopedPointer>
+#include <QUrl>
+#include <QVariantMap>
 
 class QMediaPlaylist;
 
@@ -14,6 +17,7 @@ public:
     enum Column
     {
         Title = 0,
+        Duration,
         ColumnCount
     };
 
@@ -27,22 +31,49 @@ public:
     QModelIndex parent(const QModelIndex &child) const override;
 
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
     QMediaPlaylist *playlist() const;
     void setPlaylist(QMediaPlaylist *playlist);
 
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::DisplayRole) override;
 
+    QUrl url(int row) const;
+    bool hasMediaInfo(const QUrl &url) const;
+    qint64 duration(int row) const;
+    QVariantMap tags(int row) const;
+    void setMediaInfo(const QUrl &url, qint64 duration, const QVariantMap &tags = QVariantMap());
+
+    qint64 totalDuration() const { return m_totalDuration; }
+    static QString formatDuration(qint64 duration);
+    int knownDurationCount() const { return m_knownDurationCount; }
+
+signals:
+    void totalDurationChanged(qint64 duration);
+
 private slots:
     void beginInsertItems(int start, int end);
-    void endInsertItems();
+    void endInsertItems(int start, int end);
     void beginRemoveItems(int start, int end);
     void endRemoveItems();
     void changeItems(int start, int end);
 
 private:
+    struct MediaInfo
+    {
+        qint64 duration = 0;
+        QVariantMap tags;
+    };
+
+    void addRows(int start, int end, int sign);
+    void recountRows();
+
     QScopedPointer<QMediaPlaylist> m_playlist;
     QMap<QModelIndex, QVariant> m_data;
+    QHash<QUrl, MediaInfo> m_mediaInfo;
+    QHash<QUrl, int> m_rowCount;
+    qint64 m_totalDuration = 0;
+    int m_knownDurationCount = 0;
 };
 
 #endif // PLAYLISTMODEL_H
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "positionpresenter.h"
+
+#include <QLabel>
+
+PositionPresenter::PositionPresenter(QLabel *label, QObject *parent)
+    : QObject(parent)
+    , m_label(label)
+{
+}
+
+void PositionPresenter::setDuration(qint64 duration)
+{
+    m_duration = duration / 1000;
+    m_showHours = m_duration > 3600;
+    m_totalText = QLatin1String(" / ") + formatSeconds(m_duration);
+    m_displayedSecond = -1;
+    refresh();
+}
+
+void PositionPresenter::setPosition(qint64 position)
+{
+    m_second = position / 1000;
+    if (m_second != m_displayedSecond)
+        refresh();
+}
+
+QString PositionPresenter::formatSeconds(qint64 seconds) const
+{
+    QChar text[9];
+    int length = 0;
+    auto appendTwoDigits = [&text, &length](qint64 value) {
+        text[length++] = QLatin1Char(char('0' + value / 10 % 10));
+        text[length++] = QLatin1Char(char('0' + value % 10));
+    };
+
+    if (m_showHours) {
+        appendTwoDigits(seconds / 3600);
+        text[length++] = QLatin1Char(':');
+    }
+    appendTwoDigits((seconds / 60) % 60);
+    text[length++] = QLatin1Char(':');
+    appendTwoDigits(seconds % 60);
+
+    return QString(text, length);
+}
+
+void PositionPresenter::refresh()
+{
+    m_displayedSecond = m_second;
+
+    if (!m_second && !m_duration)
+        m_label->clear();
+    else
+        m_label->setText(formatSeconds(m_second) + m_totalText);
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef POSITIONPRESENTER_H
+#define POSITIONPRESENTER_H
+
+#include <QObject>
+#include <QString>
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+QT_END_NAMESPACE
+
+// Shows "position / duration" in a label. The duration part is formatted
+// once per media and the label is only touched when the displayed second
+// actually changes, so frequent position notifications stay cheap.
+class PositionPresenter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PositionPresenter(QLabel *label, QObject *parent = nullptr);
+
+public slots:
+    void setDuration(qint64 duration);
+    void setPosition(qint64 position);
+
+private:
+    QString formatSeconds(qint64 seconds) const;
+    void refresh();
+
+    QLabel *m_label = nullptr;
+    qint64 m_duration = 0;
+    qint64 m_second = 0;
+    qint64 m_displayedSecond = -1;
+    bool m_showHours = false;
+    QString m_totalText;
+};
+
+#endif // POSITIONPRESENTER_H
\ No newline at end of file
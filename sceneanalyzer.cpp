@@ -0,0 +1,121 @@
+#include "sceneanalyzer.h"
+
+#include <QtMath>
+
+static QString formatTime(qint64 usecs)
+{
+    qint64 ms = usecs / 1000;
+    return QString("%1:%2.%3").arg(ms / 60000, 2, 10, QLatin1Char('0'))
+            .arg((ms / 1000) % 60, 2, 10, QLatin1Char('0'))
+            .arg(ms % 1000, 3, 10, QLatin1Char('0'));
+}
+
+QString SceneEvent::toString() const
+{
+    switch (type) {
+    case SceneCut:
+        return QString("%1 scene cut (%2)").arg(formatTime(time)).arg(value, 0, 'f', 2);
+    case BlackStart:
+        return QString("%1 black start").arg(formatTime(time));
+    case BlackEnd:
+        return QString("%1 black end (%2 s)").arg(formatTime(time)).arg(value, 0, 'f', 2);
+    case FreezeStart:
+        return QString("%1 freeze start").arg(formatTime(time));
+    case FreezeEnd:
+        return QString("%1 freeze end (%2 s)").arg(formatTime(time)).arg(value, 0, 'f', 2);
+    }
+    return QString();
+}
+
+QVector<SceneEvent> SceneAnalyzer::process(qint64 time, const QVector<qreal> &histogram, const QVector<quint8> &grid)
+{
+    QVector<SceneEvent> events;
+    auto addEvent = [&events](SceneEvent::Type type, qint64 at, qreal value) {
+        SceneEvent event;
+        event.type = type;
+        event.time = at;
+        event.value = value;
+        events.append(event);
+    };
+
+    // black: nearly every cell of the grid is dark
+    int darkCells = 0;
+    for (quint8 luma : grid) {
+        if (luma <= m_blackLevel)
+            ++darkCells;
+    }
+    bool black = !grid.isEmpty() && darkCells >= m_blackRatio * grid.size();
+
+    if (black && m_blackSince < 0) {
+        m_blackSince = time;
+        addEvent(SceneEvent::BlackStart, time, 0);
+    } else if (!black && m_blackSince >= 0) {
+        addEvent(SceneEvent::BlackEnd, time, (time - m_blackSince) / 1e6);
+        m_blackSince = -1;
+    }
+
+    // freeze: the grid barely changes for a while; black spans are reported on their own
+    bool still = false;
+    if (!black && grid.size() == m_previousGrid.size() && !grid.isEmpty()) {
+        int difference = 0;
+        for (int i = 0; i < grid.size(); ++i)
+            difference += qAbs(int(grid.at(i)) - int(m_previousGrid.at(i)));
+        still = qreal(difference) / grid.size() < m_freezeThreshold;
+    }
+
+    if (still) {
+        if (m_stillSince < 0)
+            m_stillSince = time;
+        if (!m_frozen && time - m_stillSince >= m_minimumFreeze) {
+            m_frozen = true;
+            addEvent(SceneEvent::FreezeStart, m_stillSince, 0);
+        }
+    } else {
+        if (m_frozen)
+            addEvent(SceneEvent::FreezeEnd, time, (time - m_stillSince) / 1e6);
+        m_frozen = false;
+        m_stillSince = -1;
+    }
+
+    // cut: the luma distribution jumps between consecutive frames
+    if (!black && histogram.size() == m_previousHistogram.size()) {
+        qreal distance = histogramDistance(m_previousHistogram, histogram);
+        if (distance > m_cutThreshold && (m_lastCut < 0 || time - m_lastCut >= m_minimumCutSpacing)) {
+            m_lastCut = time;
+            addEvent(SceneEvent::SceneCut, time, distance);
+        }
+    }
+
+    m_previousHistogram = histogram;
+    m_previousGrid = grid;
+    return events;
+}
+
+void SceneAnalyzer::reset()
+{
+    m_previousHistogram.clear();
+    m_previousGrid.clear();
+    m_lastCut = -1;
+    m_blackSince = -1;
+    m_stillSince = -1;
+    m_frozen = false;
+}
+
+// Half the L1 distance of the two histograms normalized to unit area, so
+// 0 is identical and 1 is disjoint.
+qreal SceneAnalyzer::histogramDistance(const QVector<qreal> &a, const QVector<qreal> &b)
+{
+    qreal sumA = 0;
+    qreal sumB = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        sumA += a.at(i);
+        sumB += b.at(i);
+    }
+    if (sumA <= 0 || sumB <= 0)
+        return 0;
+
+    qreal distance = 0;
+    for (int i = 0; i < a.size(); ++i)
+        distance += qAbs(a.at(i) / sumA - b.at(i) / sumB);
+    return distance / 2;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef SCENEANALYZER_H
+#define SCENEANALYZER_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+struct SceneEvent
+{
+    enum Type
+    {
+        SceneCut,
+        BlackStart,
+        BlackEnd,
+        FreezeStart,
+        FreezeEnd
+    };
+
+    Type type = SceneCut;
+    qint64 time = 0;    // frame start time in microseconds
+    qreal value = 0;    // cut distance, or the duration in seconds of an ended span
+
+    QString toString() const;
+};
+
+Q_DECLARE_METATYPE(SceneEvent)
+
+// Detects scene cuts, black frames and frozen frames one frame at a time.
+//
+// Cuts compare the luma histograms of consecutive frames; black and freeze
+// detection look at a small grid of mean luma values. Only the previous
+// frame's histogram and grid are kept, so memory stays constant however long
+// the stream runs.
+class SceneAnalyzer
+{
+public:
+    void setCutThreshold(qreal distance) { m_cutThreshold = distance; }
+    void setBlackLevel(int luma) { m_blackLevel = luma; }
+    void setBlackRatio(qreal ratio) { m_blackRatio = ratio; }
+    void setFreezeThreshold(qreal difference) { m_freezeThreshold = difference; }
+    void setMinimumFreezeDuration(qint64 usecs) { m_minimumFreeze = usecs; }
+
+    QVector<SceneEvent> process(qint64 time, const QVector<qreal> &histogram, const QVector<quint8> &grid);
+    void reset();
+
+private:
+    static qreal histogramDistance(const QVector<qreal> &a, const QVector<qreal> &b);
+
+    qreal m_cutThreshold = 0.4;
+    int m_blackLevel = 32;
+    qreal m_blackRatio = 0.98;
+    qreal m_freezeThreshold = 0.5;
+    qint64 m_minimumFreeze = 1000000;
+    qint64 m_minimumCutSpacing = 300000;
+
+    QVector<qreal> m_previousHistogram;
+    QVector<quint8> m_previousGrid;
+    qint64 m_lastCut = -1;
+    qint64 m_blackSince = -1;
+    qint64 m_stillSince = -1;
+    bool m_frozen = false;
+};
+
+#endif // SCENEANALYZER_H
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "scopewidget.h"
+#include "analysisexecutor.h"
+#include "analysispresenter.h"
+#include "tracer.h"
+#include "videoframeview.h"
+
+#include <QPainter>
+
+static const int MaxWaveformWidth = 1024;
+static const int WaveformRows = 256;
+static const int VectorscopeSamples = 256 * 256;
+
+void ScopeRenderer::render(QVideoFrame frame, int mode, int width)
+{
+    TRACE_SCOPE("ScopeRenderer::render");
+    VideoFrameView view(frame);
+    QImage image;
+
+    if (view.isValid())
+        image = mode == ScopeWidget::Vectorscope ? renderVectorscope(view) : renderWaveform(view, width);
+
+    emit imageReady(frame.startTime(), image);
+}
+
+// One output column per decimated source column, one row per luma value.
+QImage ScopeRenderer::renderWaveform(const VideoFrameView &view, int width)
+{
+    const int columns = qBound(1, qMin(width, view.width()), MaxWaveformWidth);
+    const int rows = qMin(view.height(), 270);
+
+    m_accumulator.fill(0, columns * WaveformRows);
+    for (int row = 0; row < rows; ++row) {
+        int y = (row * 2 + 1) * view.height() / (rows * 2);
+        for (int column = 0; column < columns; ++column) {
+            int x = (column * 2 + 1) * view.width() / (columns * 2);
+            ++m_accumulator[view.luma(x, y) * columns + column];
+        }
+    }
+
+    // a column spread evenly over all levels shows at a quarter brightness
+    const quint32 gain = qMax(1, 64 * WaveformRows / rows);
+    QImage image(columns, WaveformRows, QImage::Format_RGB32);
+    for (int level = 0; level < WaveformRows; ++level) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(WaveformRows - 1 - level));
+        const quint32 *counts = m_accumulator.constData() + level * columns;
+        for (int column = 0; column < columns; ++column) {
+            int value = int(qMin<quint32>(255, counts[column] * gain));
+            line[column] = qRgb(value / 4, value, value / 4);
+        }
+    }
+    return image;
+}
+
+// U to the right, V upwards, both centered on neutral grey.
+QImage ScopeRenderer::renderVectorscope(const VideoFrameView &view)
+{
+    const int columns = qMin(view.width(), 256);
+    const int rows = qMax(1, qMin(view.height(), VectorscopeSamples / columns));
+
+    m_accumulator.fill(0, 256 * 256);
+    for (int row = 0; row < rows; ++row) {
+        int y = (row * 2 + 1) * view.height() / (rows * 2);
+        for (int column = 0; column < columns; ++column) {
+            int x = (column * 2 + 1) * view.width() / (columns * 2);
+            int u = 0;
+            int v = 0;
+            view.chroma(x, y, &u, &v);
+            ++m_accumulator[(255 - v) * 256 + u];
+        }
+    }
+
+    const quint32 gain = qMax(1, 64 * 256 * 256 / (rows * columns));
+    QImage image(256, 256, QImage::Format_RGB32);
+    for (int y = 0; y < 256; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        const quint32 *counts = m_accumulator.constData() + y * 256;
+        for (int x = 0; x < 256; ++x) {
+            int value = int(qMin<quint32>(255, counts[x] * gain));
+            line[x] = qRgb(value, value, value);
+        }
+    }
+    return image;
+}
+
+ScopeWidget::ScopeWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    connect(&m_renderer, &ScopeRenderer::imageReady, this, &ScopeWidget::setImage);
+    setMinimumSize(64, 64);
+}
+
+ScopeWidget::~ScopeWidget()
+{
+    AnalysisExecutor::instance()->cancel(&m_renderer);
+}
+
+void ScopeWidget::setMode(Mode mode)
+{
+    if (m_mode == mode)
+        return;
+
+    m_mode = mode;
+    m_image = QImage();
+    update();
+}
+
+void ScopeWidget::processFrame(const QVideoFrame &frame)
+{
+    if (!isVisible() || (m_isBusy && frame.isValid()))
+        return; //drop frame
+
+    m_isBusy = true;
+    ScopeRenderer *renderer = &m_renderer;
+    const int mode = m_mode;
+    const int w = width();
+    AnalysisExecutor::instance()->submit(renderer, [renderer, frame, mode, w]() {
+        renderer->render(frame, mode, w);
+    });
+}
+
+void ScopeWidget::setImage(qint64 startTime, const QImage &image)
+{
+    m_isBusy = false;
+    if (m_presenter && !m_presenter->isCurrent(startTime))
+        return;
+
+    m_image = image;
+    update();
+}
+
+void ScopeWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    TRACE_SCOPE("ScopeWidget::paintEvent");
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+
+    QRect target = rect();
+    if (m_mode == Vectorscope) {
+        int side = qMin(width(), height());
+        target = QRect((width() - side) / 2, (height() - side) / 2, side, side);
+    }
+
+    if (!m_image.isNull())
+        painter.drawImage(target, m_image);
+
+    painter.setPen(QColor(255, 255, 255, 60));
+    if (m_mode == Vectorscope) {
+        painter.drawEllipse(target.adjusted(2, 2, -2, -2));
+        painter.drawLine(target.center().x(), target.top(), target.center().x(), target.bottom());
+        painter.drawLine(target.left(), target.center().y(), target.right(), target.center().y());
+    } else {
+        for (int i = 1; i < 4; ++i)
+            painter.drawLine(0, height() * i / 4, width(), height() * i / 4);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef SCOPEWIDGET_H
+#define SCOPEWIDGET_H
+
+#include <QImage>
+#include <QVector>
+#include <QVideoFrame>
+#include <QWidget>
+
+class AnalysisPresenter;
+class VideoFrameView;
+
+// Renders scope images from mapped frames. The accumulation buffer is kept
+// between frames and every frame is sampled on a fixed budget, so the cost
+// per frame is bounded whatever the source resolution.
+class ScopeRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    void render(QVideoFrame frame, int mode, int width);
+
+signals:
+    void imageReady(qint64 startTime, const QImage &image);
+
+private:
+    QImage renderWaveform(const VideoFrameView &view, int width);
+    QImage renderVectorscope(const VideoFrameView &view);
+
+    QVector<quint32> m_accumulator;
+};
+
+// Luma waveform monitor or UV vectorscope of the probed video.
+class ScopeWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        Waveform,
+        Vectorscope
+    };
+
+    explicit ScopeWidget(QWidget *parent = nullptr);
+    ~ScopeWidget();
+
+    Mode mode() const { return m_mode; }
+    void setMode(Mode mode);
+    void setPresenter(AnalysisPresenter *presenter) { m_presenter = presenter; }
+
+public slots:
+    void processFrame(const QVideoFrame &frame);
+    void setImage(qint64 startTime, const QImage &image);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    Mode m_mode = Waveform;
+    QImage m_image;
+    ScopeRenderer m_renderer;
+    AnalysisPresenter *m_presenter = nullptr;
+    bool m_isBusy = false;
+};
+
+#endif // SCOPEWIDGET_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "seekcontroller.h"
+
+#include <QMediaPlayer>
+
+// How close a reported position has to be to count as the seek landing.
+static const qint64 SeekTolerance = 500;
+
+SeekController::SeekController(QObject *parent)
+    : QObject(parent)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(300);
+    connect(&m_timeout, &QTimer::timeout, this, &SeekController::completeSeek);
+
+    m_throttle.setSingleShot(true);
+    connect(&m_throttle, &QTimer::timeout, this, [this]() {
+        if (m_target < 0)
+            issuePending();
+    });
+}
+
+void SeekController::setPlayer(QMediaPlayer *player)
+{
+    if (m_player)
+        disconnect(m_player, nullptr, this, nullptr);
+
+    m_player = player;
+    m_target = -1;
+    m_pending = -1;
+    m_timeout.stop();
+    m_throttle.stop();
+
+    if (m_player)
+        connect(m_player, &QMediaPlayer::positionChanged, this, &SeekController::positionChanged);
+}
+
+void SeekController::setFrameRate(qreal fps)
+{
+    if (fps > 0)
+        setFrameDuration(qRound64(1000 / fps));
+}
+
+qint64 SeekController::targetPosition() const
+{
+    if (m_pending >= 0)
+        return m_pending;
+    if (m_target >= 0)
+        return m_target;
+    return m_player ? m_player->position() : 0;
+}
+
+void SeekController::seek(qint64 position)
+{
+    m_pending = position;
+    if (m_target < 0)
+        issuePending();
+}
+
+void SeekController::seekNow(qint64 position)
+{
+    m_pending = -1;
+    m_throttle.stop();
+    issue(position);
+}
+
+void SeekController::stepFrames(int frames)
+{
+    if (!m_player)
+        return;
+
+    if (m_player->state() == QMediaPlayer::PlayingState)
+        m_player->pause();
+
+    qint64 position = targetPosition() + frames * m_frameDuration;
+    if (m_player->duration() > 0)
+        position = qMin(position, m_player->duration());
+    seekNow(qMax<qint64>(0, position));
+}
+
+void SeekController::positionChanged(qint64 position)
+{
+    if (m_target >= 0 && qAbs(position - m_target) <= SeekTolerance)
+        completeSeek();
+}
+
+void SeekController::completeSeek()
+{
+    m_timeout.stop();
+    m_target = -1;
+    issuePending();
+}
+
+void SeekController::issuePending()
+{
+    if (m_pending < 0 || m_throttle.isActive())
+        return;
+
+    // Keep the request rate bounded even when the backend answers fast.
+    int wait = m_sinceIssue.isValid() ? m_minInterval - int(m_sinceIssue.elapsed()) : 0;
+    if (wait > 0) {
+        m_throttle.start(wait);
+        return;
+    }
+
+    qint64 position = m_pending;
+    m_pending = -1;
+    issue(position);
+}
+
+void SeekController::issue(qint64 position)
+{
+    if (!m_player)
+        return;
+
+    m_target = position;
+    m_sinceIssue.start();
+    m_timeout.start();
+    m_player->setPosition(position);
+}
\ No newline at end of file
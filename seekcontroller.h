@@ -0,0 +1,56 @@
+#ifndef SEEKCONTROLLER_H
+#define SEEKCONTROLLER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+QT_BEGIN_NAMESPACE
+class QMediaPlayer;
+QT_END_NAMESPACE
+
+// Coalesces seek requests so the backend only ever has one seek in flight.
+// While a seek is pending completion newer requests replace each other and
+// only the latest is issued once the player reports a position near the
+// previous target (or the completion timeout fires).
+class SeekController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SeekController(QObject *parent = nullptr);
+
+    void setPlayer(QMediaPlayer *player);
+
+    qint64 frameDuration() const { return m_frameDuration; }
+    void setFrameDuration(qint64 msecs) { m_frameDuration = qMax<qint64>(1, msecs); }
+    void setFrameRate(qreal fps);
+
+    bool isSeeking() const { return m_target >= 0 || m_pending >= 0; }
+    qint64 targetPosition() const;
+
+public slots:
+    void seek(qint64 position);
+    void seekNow(qint64 position);
+    void stepFrames(int frames);
+
+private slots:
+    void positionChanged(qint64 position);
+    void completeSeek();
+
+private:
+    void issue(qint64 position);
+    void issuePending();
+
+    QPointer<QMediaPlayer> m_player;
+    qint64 m_target = -1;
+    qint64 m_pending = -1;
+    qint64 m_frameDuration = 40;
+    QElapsedTimer m_sinceIssue;
+    QTimer m_timeout;
+    QTimer m_throttle;
+    int m_minInterval = 30;
+};
+
+#endif // SEEKCONTROLLER_H
\ No newline at end of file
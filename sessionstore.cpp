@@ -0,0 +1,268 @@
+#include "sessionstore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+
+static const quint32 SessionMagic = 0x53505651; // "QVPS"
+static const quint16 SessionVersion = 1;
+static const int StateOffset = 8;
+static const int StateSize = 24;
+static const int HeaderSize = StateOffset + StateSize + 4;
+static const int MinEntrySize = 4 + 4 + 8;
+
+template <class T>
+static void appendValue(QByteArray &data, T value)
+{
+    const int offset = data.size();
+    data.resize(offset + int(sizeof(T)));
+    qToLittleEndian<T>(value, data.data() + offset);
+}
+
+static void appendBytes(QByteArray &data, const QByteArray &bytes)
+{
+    appendValue<quint32>(data, quint32(bytes.size()));
+    data.append(bytes);
+}
+
+static bool readBytes(const uchar *&cur, const uchar *end, QByteArray *bytes)
+{
+    if (end - cur < 4)
+        return false;
+    const quint32 size = qFromLittleEndian<quint32>(cur);
+    cur += 4;
+    if (quint64(end - cur) < size)
+        return false;
+    *bytes = QByteArray(reinterpret_cast<const char *>(cur), int(size));
+    cur += size;
+    return true;
+}
+
+static quint64 doubleBits(double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double doubleFromBits(quint64 bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+SessionStore::SessionStore(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{
+    m_writeTimer.setSingleShot(true);
+    m_writeTimer.setInterval(1000);
+    connect(&m_writeTimer, &QTimer::timeout, this, &SessionStore::flush);
+}
+
+SessionStore::~SessionStore()
+{
+    flush();
+}
+
+bool SessionStore::load()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < HeaderSize)
+        return false;
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (!data)
+        return false;
+
+    bool ok = false;
+
+    do {
+        if (qFromLittleEndian<quint32>(data) != SessionMagic)
+            break;
+        if (qFromLittleEndian<quint16>(data + 4) != SessionVersion)
+            break;
+
+        const quint32 count = qFromLittleEndian<quint32>(data + StateOffset + StateSize);
+        if (count > quint64(size - HeaderSize) / MinEntrySize)
+            break;
+
+        QVector<Entry> entries;
+        entries.reserve(int(count));
+
+        const uchar *cur = data + HeaderSize;
+        const uchar *end = data + size;
+        QByteArray url;
+        QByteArray title;
+        quint32 i = 0;
+        for (; i < count; ++i) {
+            if (!readBytes(cur, end, &url) || !readBytes(cur, end, &title) || end - cur < 8)
+                break;
+
+            Entry entry;
+            entry.url = QUrl::fromEncoded(url);
+            entry.title = QString::fromUtf8(title);
+            entry.duration = qFromLittleEndian<qint64>(cur);
+            cur += 8;
+            entries.append(entry);
+        }
+        if (i != count)
+            break;
+
+        m_entries = entries;
+        rebuildIndex();
+        m_currentIndex = qFromLittleEndian<qint32>(data + StateOffset);
+        m_position = qFromLittleEndian<qint64>(data + StateOffset + 4);
+        m_playbackRate = doubleFromBits(qFromLittleEndian<quint64>(data + StateOffset + 12));
+        m_volume = qFromLittleEndian<qint32>(data + StateOffset + 20);
+        ok = true;
+    } while (false);
+
+    file.unmap(const_cast<uchar *>(data));
+    return ok;
+}
+
+void SessionStore::setEntries(const QVector<Entry> &entries)
+{
+    m_entries = entries;
+    rebuildIndex();
+    scheduleWrite(true);
+}
+
+void SessionStore::rebuildIndex()
+{
+    m_index.clear();
+    m_index.reserve(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i)
+        m_index[m_entries.at(i).url].append(i);
+}
+
+void SessionStore::setMediaInfo(const QUrl &url, const QString &title, qint64 duration)
+{
+    bool changed = false;
+
+    // Keep what was cached until the backend reports something better.
+    const QVector<int> rows = m_index.value(url);
+    for (int row : rows) {
+        Entry &entry = m_entries[row];
+        if (!title.isEmpty() && entry.title != title) {
+            entry.title = title;
+            changed = true;
+        }
+        if (duration > 0 && entry.duration != duration) {
+            entry.duration = duration;
+            changed = true;
+        }
+    }
+
+    if (changed)
+        scheduleWrite(true);
+}
+
+void SessionStore::setCurrentIndex(int index)
+{
+    if (m_currentIndex != index) {
+        m_currentIndex = index;
+        scheduleWrite(false);
+    }
+}
+
+void SessionStore::setPosition(qint64 position)
+{
+    if (m_position != position) {
+        m_position = position;
+        scheduleWrite(false);
+    }
+}
+
+void SessionStore::setPlaybackRate(qreal rate)
+{
+    if (!qFuzzyCompare(m_playbackRate, rate)) {
+        m_playbackRate = rate;
+        scheduleWrite(false);
+    }
+}
+
+void SessionStore::setVolume(int volume)
+{
+    if (m_volume != volume) {
+        m_volume = volume;
+        scheduleWrite(false);
+    }
+}
+
+void SessionStore::flush()
+{
+    m_writeTimer.stop();
+
+    if (m_entriesDirty) {
+        if (writeAll())
+            m_entriesDirty = m_stateDirty = false;
+    } else if (m_stateDirty) {
+        if (writeState())
+            m_stateDirty = false;
+    }
+}
+
+void SessionStore::scheduleWrite(bool entriesChanged)
+{
+    if (entriesChanged)
+        m_entriesDirty = true;
+    else
+        m_stateDirty = true;
+
+    if (!m_writeTimer.isActive())
+        m_writeTimer.start();
+}
+
+QByteArray SessionStore::encodeState() const
+{
+    QByteArray state;
+    state.reserve(StateSize);
+    appendValue<qint32>(state, m_currentIndex);
+    appendValue<qint64>(state, m_position);
+    appendValue<quint64>(state, doubleBits(m_playbackRate));
+    appendValue<qint32>(state, m_volume);
+    return state;
+}
+
+bool SessionStore::writeAll()
+{
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+    QByteArray data;
+    appendValue<quint32>(data, SessionMagic);
+    appendValue<quint16>(data, SessionVersion);
+    appendValue<quint16>(data, 0);
+    data.append(encodeState());
+    appendValue<quint32>(data, quint32(m_entries.size()));
+    for (const Entry &entry : qAsConst(m_entries)) {
+        appendBytes(data, entry.url.toEncoded());
+        appendBytes(data, entry.title.toUtf8());
+        appendValue<qint64>(data, entry.duration);
+    }
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(data);
+    return file.commit();
+}
+
+bool SessionStore::writeState()
+{
+    QFile file(m_fileName);
+    if (!file.exists() || file.size() < HeaderSize)
+        return writeAll();
+
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(StateOffset))
+        return false;
+
+    return file.write(encodeState()) == StateSize;
+}
\ No newline at end of file
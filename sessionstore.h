@@ -0,0 +1,74 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+// Persists the playlist and playback state in a small versioned binary file.
+//
+// Layout (little-endian):
+//   header: magic, version, flags, current index, position, rate, volume, entry count
+//   entries: url (utf-8, length prefixed), title (utf-8, length prefixed), duration
+//
+// The playback state lives at a fixed offset in the header so position/volume
+// updates only patch those bytes; the entries are rewritten only when the
+// playlist itself changes.
+class SessionStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry
+    {
+        QUrl url;
+        QString title;
+        qint64 duration = 0;
+    };
+
+    explicit SessionStore(const QString &fileName, QObject *parent = nullptr);
+    ~SessionStore();
+
+    QString fileName() const { return m_fileName; }
+
+    bool load();
+
+    QVector<Entry> entries() const { return m_entries; }
+    int currentIndex() const { return m_currentIndex; }
+    qint64 position() const { return m_position; }
+    qreal playbackRate() const { return m_playbackRate; }
+    int volume() const { return m_volume; }
+
+    void setEntries(const QVector<Entry> &entries);
+    void setMediaInfo(const QUrl &url, const QString &title, qint64 duration);
+    void setCurrentIndex(int index);
+    void setPosition(qint64 position);
+    void setPlaybackRate(qreal rate);
+    void setVolume(int volume);
+
+public slots:
+    void flush();
+
+private:
+    void scheduleWrite(bool entriesChanged);
+    void rebuildIndex();
+    bool writeAll();
+    bool writeState();
+    QByteArray encodeState() const;
+
+    QString m_fileName;
+    QVector<Entry> m_entries;
+    QHash<QUrl, QVector<int>> m_index; // rows of each url in m_entries
+    int m_currentIndex = -1;
+    qint64 m_position = 0;
+    qreal m_playbackRate = 1.0;
+    int m_volume = 100;
+
+    bool m_entriesDirty = false;
+    bool m_stateDirty = false;
+    QTimer m_writeTimer;
+};
+
+#endif // SESSIONSTORE_H
\ No newline at end of file
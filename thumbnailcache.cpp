@@ -0,0 +1,345 @@
+#include "thumbnailcache.h"
+#include "mediafingerprint.h"
+#include "videoframesurface.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+static const quint32 ThumbnailMagic = 0x48545651; // "QVTH"
+static const quint16 ThumbnailVersion = 1;
+static const int MaxRequestedSlots = 4;
+
+void ThumbnailWriter::openPack(int generation, const QUrl &url, qint64 interval, int width)
+{
+    const QString packFile = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+            + "/thumbnails/" + mediaFingerprint(url) + ".thumbs";
+    ThumbnailIndex index;
+
+    QFile file(packFile);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        quint32 magic = 0;
+        quint16 version = 0;
+        qint32 packWidth = 0;
+        qint64 packInterval = 0;
+        in >> magic >> version >> packWidth >> packInterval;
+
+        if (magic != ThumbnailMagic || version != ThumbnailVersion
+                || packWidth != width || packInterval != interval) {
+            file.close();
+            file.remove();
+        } else {
+            while (!in.atEnd()) {
+                qint64 offset = file.pos();
+                qint32 slot = 0;
+                quint32 size = 0;
+                in >> slot >> size;
+                if (in.status() != QDataStream::Ok || in.skipRawData(int(size)) != int(size))
+                    break;
+                index.insert(slot, offset);
+            }
+        }
+    }
+
+    emit packOpened(generation, packFile, index);
+}
+
+void ThumbnailWriter::readThumbnail(const QString &packFile, int slot, qint64 offset)
+{
+    QImage image;
+
+    QFile file(packFile);
+    if (file.open(QIODevice::ReadOnly) && file.seek(offset)) {
+        QDataStream in(&file);
+        qint32 storedSlot = 0;
+        QByteArray bytes;
+        in >> storedSlot >> bytes;
+        if (storedSlot == slot)
+            image = QImage::fromData(bytes, "JPG");
+    }
+
+    emit thumbnailRead(packFile, slot, image);
+}
+
+void ThumbnailWriter::storeFrame(QVideoFrame frame, const QString &packFile, int slot, qint64 interval, int width)
+{
+    QImage image;
+
+    if (frame.map(QAbstractVideoBuffer::ReadOnly)) {
+        QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(frame.pixelFormat());
+        if (imageFormat != QImage::Format_Invalid) {
+            image = QImage(frame.bits(), frame.width(), frame.height(), frame.bytesPerLine(), imageFormat)
+                    .scaledToWidth(width, Qt::SmoothTransformation);
+        }
+        frame.unmap();
+    }
+
+    qint64 offset = -1;
+
+    if (!image.isNull()) {
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "JPG", 75);
+
+        QDir().mkpath(QFileInfo(packFile).absolutePath());
+        QFile file(packFile);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            QDataStream out(&file);
+            if (file.size() == 0)
+                out << ThumbnailMagic << ThumbnailVersion << qint32(width) << interval;
+            offset = file.pos();
+            out << qint32(slot) << bytes;
+        }
+    }
+
+    emit frameStored(packFile, slot, offset, image);
+}
+
+ThumbnailCache::ThumbnailCache(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<ThumbnailIndex>("ThumbnailIndex");
+    m_memory.setMaxCost(128);
+
+    m_surface = new VideoFrameSurface(this);
+    m_extractor = new QMediaPlayer(this);
+    m_extractor->setMuted(true);
+    m_extractor->setVideoOutput(m_surface);
+
+    connect(m_surface, &VideoFrameSurface::frameAvailable, this, &ThumbnailCache::frameAvailable);
+    connect(m_extractor, &QMediaPlayer::mediaStatusChanged, this, &ThumbnailCache::statusChanged);
+
+    m_captureTimer.setSingleShot(true);
+    m_captureTimer.setInterval(3000);
+    connect(&m_captureTimer, &QTimer::timeout, this, &ThumbnailCache::captureTimedOut);
+
+    m_writer.moveToThread(&m_writerThread);
+    connect(&m_writer, &ThumbnailWriter::packOpened, this, &ThumbnailCache::packOpened);
+    connect(&m_writer, &ThumbnailWriter::thumbnailRead, this, &ThumbnailCache::thumbnailRead);
+    connect(&m_writer, &ThumbnailWriter::frameStored, this, &ThumbnailCache::frameStored);
+    m_writerThread.start(QThread::LowestPriority);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_writerThread.quit();
+    m_writerThread.wait();
+}
+
+void ThumbnailCache::setMedia(const QUrl &url, qint64 duration)
+{
+    if (url == m_url && duration == m_duration)
+        return;
+
+    m_captureTimer.stop();
+    m_extractor->stop();
+    m_extractor->setMedia(QMediaContent());
+
+    m_url = url;
+    m_duration = duration;
+    m_memory.clear();
+    m_diskIndex.clear();
+    m_requested.clear();
+    m_failed.clear();
+    m_storing.clear();
+    m_reading.clear();
+    m_fillSlot = 0;
+    m_busySlot = -1;
+    m_slotCount = 0;
+    m_packFile.clear();
+    ++m_generation;
+
+    if (url.isEmpty() || duration <= 0)
+        return;
+
+    m_interval = qMax<qint64>(1000, duration / 120);
+    m_slotCount = int((duration + m_interval - 1) / m_interval);
+
+    // Fingerprinting reads the file; nothing is decoded until the pack is open.
+    QMetaObject::invokeMethod(&m_writer, "openPack", Qt::QueuedConnection,
+                              Q_ARG(int, m_generation), Q_ARG(QUrl, url),
+                              Q_ARG(qint64, m_interval), Q_ARG(int, m_thumbnailWidth));
+}
+
+void ThumbnailCache::packOpened(int generation, const QString &packFile, const ThumbnailIndex &index)
+{
+    if (generation != m_generation)
+        return;
+
+    m_packFile = packFile;
+    m_diskIndex = index;
+    startNext();
+}
+
+int ThumbnailCache::slotAt(qint64 position) const
+{
+    if (!m_slotCount)
+        return -1;
+
+    return int(qBound<qint64>(0, position / m_interval, m_slotCount - 1));
+}
+
+QImage ThumbnailCache::thumbnail(qint64 position)
+{
+    int slot = slotAt(position);
+    if (slot < 0)
+        return QImage();
+
+    if (QImage *image = m_memory.object(slot))
+        return *image;
+
+    if (m_diskIndex.contains(slot)) {
+        if (!m_reading.contains(slot)) {
+            m_reading.insert(slot);
+            QMetaObject::invokeMethod(&m_writer, "readThumbnail", Qt::QueuedConnection,
+                                      Q_ARG(QString, m_packFile), Q_ARG(int, slot),
+                                      Q_ARG(qint64, m_diskIndex.value(slot)));
+        }
+        return QImage();
+    }
+
+    requestSlot(slot);
+    return QImage();
+}
+
+void ThumbnailCache::thumbnailRead(const QString &packFile, int slot, const QImage &image)
+{
+    if (packFile != m_packFile)
+        return;
+
+    m_reading.remove(slot);
+    if (image.isNull()) {
+        m_diskIndex.remove(slot);
+        requestSlot(slot);
+        return;
+    }
+
+    m_memory.insert(slot, new QImage(image));
+    emit thumbnailReady(slot);
+}
+
+void ThumbnailCache::requestSlot(int slot)
+{
+    if (slot == m_busySlot || m_failed.contains(slot) || m_storing.contains(slot))
+        return;
+
+    m_requested.removeAll(slot);
+    m_requested.prepend(slot);
+    while (m_requested.size() > MaxRequestedSlots)
+        m_requested.removeLast();
+
+    startNext();
+}
+
+void ThumbnailCache::startNext()
+{
+    if (m_busySlot >= 0 || !m_slotCount || m_packFile.isEmpty())
+        return;
+
+    int slot = -1;
+    while (slot < 0 && !m_requested.isEmpty()) {
+        int next = m_requested.takeFirst();
+        if (!m_diskIndex.contains(next) && !m_failed.contains(next) && !m_storing.contains(next))
+            slot = next;
+    }
+    while (slot < 0 && m_backgroundFill && m_fillSlot < m_slotCount) {
+        int next = m_fillSlot++;
+        if (!m_diskIndex.contains(next) && !m_failed.contains(next) && !m_storing.contains(next))
+            slot = next;
+    }
+    if (slot < 0)
+        return;
+
+    m_busySlot = slot;
+    m_seekIssued = false;
+    m_captureTimer.start();
+
+    // The extractor is only opened once something is actually missing.
+    if (m_extractor->media().isNull()) {
+        m_extractor->setMedia(QMediaContent(m_url));
+        m_extractor->pause();
+    } else {
+        statusChanged(m_extractor->mediaStatus());
+    }
+}
+
+void ThumbnailCache::seekToBusySlot()
+{
+    m_seekIssued = true;
+    m_extractor->setPosition(qMin(m_busySlot * m_interval + m_interval / 2, m_duration - 1));
+}
+
+void ThumbnailCache::statusChanged(QMediaPlayer::MediaStatus status)
+{
+    if (m_busySlot < 0)
+        return;
+
+    switch (status) {
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferingMedia:
+    case QMediaPlayer::BufferedMedia:
+        if (!m_seekIssued)
+            seekToBusySlot();
+        break;
+    case QMediaPlayer::InvalidMedia:
+        m_captureTimer.stop();
+        m_busySlot = -1;
+        m_slotCount = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+void ThumbnailCache::frameAvailable(const QVideoFrame &frame)
+{
+    if (m_busySlot < 0 || !m_seekIssued)
+        return;
+
+    // Skip a frame still queued from before the seek.
+    qint64 target = m_busySlot * m_interval + m_interval / 2;
+    if (frame.startTime() >= 0 && qAbs(frame.startTime() / 1000 - target) > m_interval)
+        return;
+
+    QMetaObject::invokeMethod(&m_writer, "storeFrame", Qt::QueuedConnection,
+                              Q_ARG(QVideoFrame, frame), Q_ARG(QString, m_packFile),
+                              Q_ARG(int, m_busySlot), Q_ARG(qint64, m_interval),
+                              Q_ARG(int, m_thumbnailWidth));
+    m_storing.insert(m_busySlot);
+    finishSlot();
+}
+
+void ThumbnailCache::frameStored(const QString &packFile, int slot, qint64 offset, const QImage &image)
+{
+    if (packFile != m_packFile)
+        return;
+
+    m_storing.remove(slot);
+    if (offset >= 0)
+        m_diskIndex.insert(slot, offset);
+    else
+        m_failed.insert(slot);
+
+    if (!image.isNull()) {
+        m_memory.insert(slot, new QImage(image));
+        emit thumbnailReady(slot);
+    }
+}
+
+void ThumbnailCache::captureTimedOut()
+{
+    m_failed.insert(m_busySlot);
+    finishSlot();
+}
+
+void ThumbnailCache::finishSlot()
+{
+    m_captureTimer.stop();
+    m_busySlot = -1;
+    QTimer::singleShot(0, this, &ThumbnailCache::startNext);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMediaPlayer>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <QVideoFrame>
+
+class VideoFrameSurface;
+
+// Slot -> offset of its record in a pack file.
+typedef QHash<int, qint64> ThumbnailIndex;
+
+// Does all pack file I/O off the GUI thread: fingerprinting the media and
+// indexing its pack, reading thumbnails back and appending new ones.
+class ThumbnailWriter : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void openPack(int generation, const QUrl &url, qint64 interval, int width);
+    void readThumbnail(const QString &packFile, int slot, qint64 offset);
+    void storeFrame(QVideoFrame frame, const QString &packFile, int slot, qint64 interval, int width);
+
+signals:
+    void packOpened(int generation, const QString &packFile, const ThumbnailIndex &index);
+    void thumbnailRead(const QString &packFile, int slot, const QImage &image);
+    void frameStored(const QString &packFile, int slot, qint64 offset, const QImage &image);
+};
+
+// Seek preview thumbnails for the current media.
+//
+// The media is split into evenly spaced slots. A slot's thumbnail comes from
+// the in-memory LRU, then from the on-disk pack file of the media (keyed by
+// its content fingerprint), and is otherwise decoded on demand by a hidden
+// paused QMediaPlayer. Requested slots go first; idle time fills the rest.
+// Only the LRU is served synchronously; disk reads complete with
+// thumbnailReady().
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailCache(QObject *parent = nullptr);
+    ~ThumbnailCache();
+
+    void setThumbnailWidth(int width) { m_thumbnailWidth = width; }
+    void setBackgroundFill(bool enabled) { m_backgroundFill = enabled; }
+
+    void setMedia(const QUrl &url, qint64 duration);
+    int slotAt(qint64 position) const;
+    QImage thumbnail(qint64 position);
+
+signals:
+    void thumbnailReady(int slot);
+
+private slots:
+    void frameAvailable(const QVideoFrame &frame);
+    void packOpened(int generation, const QString &packFile, const ThumbnailIndex &index);
+    void thumbnailRead(const QString &packFile, int slot, const QImage &image);
+    void frameStored(const QString &packFile, int slot, qint64 offset, const QImage &image);
+    void statusChanged(QMediaPlayer::MediaStatus status);
+    void captureTimedOut();
+
+private:
+    void requestSlot(int slot);
+    void startNext();
+    void seekToBusySlot();
+    void finishSlot();
+
+    QUrl m_url;
+    qint64 m_duration = 0;
+    qint64 m_interval = 0;
+    int m_slotCount = 0;
+    int m_thumbnailWidth = 160;
+    bool m_backgroundFill = true;
+
+    int m_generation = 0;
+    QString m_packFile;
+    ThumbnailIndex m_diskIndex;
+    QCache<int, QImage> m_memory;
+    QList<int> m_requested;
+    QSet<int> m_failed;
+    QSet<int> m_storing;
+    QSet<int> m_reading;
+    int m_fillSlot = 0;
+    int m_busySlot = -1;
+    bool m_seekIssued = false;
+
+    QMediaPlayer *m_extractor = nullptr;
+    VideoFrameSurface *m_surface = nullptr;
+    QTimer m_captureTimer;
+    ThumbnailWriter m_writer;
+    QThread m_writerThread;
+};
+
+#endif // THUMBNAILCACHE_H
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "timestretch.h"
+#include "tracer.h"
+
+#include <QAudio>
+#include <QAudioDeviceInfo>
+#include <QAudioOutput>
+#include <QDebug>
+#include <QtMath>
+
+#include <cstring>
+
+static const int MaxWriteFrames = 8192;
+
+void TimeStretch::setFormat(int sampleRate, int channels)
+{
+    m_channels = qMax(1, channels);
+    m_window = qMax(64, sampleRate / 40) & ~1; // 25 ms
+    m_hop = m_window / 2;
+    m_radius = qMax(8, sampleRate / 200);      // +-5 ms
+    m_capacity = 2 * (m_window + 2 * m_radius) + 4 * m_hop + MaxWriteFrames;
+
+    m_input.resize(m_capacity * m_channels);
+    m_mono.resize(m_capacity);
+    m_overlap.resize(m_hop * m_channels);
+    m_target.resize(m_hop);
+    m_hann.resize(m_window);
+    for (int i = 0; i < m_window; ++i)
+        m_hann[i] = float(0.5 - 0.5 * qCos(2 * M_PI * i / m_window));
+
+    reset();
+}
+
+void TimeStretch::setRate(qreal rate)
+{
+    m_rate = qBound<qreal>(0.25, rate, 4.0);
+}
+
+void TimeStretch::reset()
+{
+    m_inputFrames = 0;
+    m_position = 0;
+    m_hasTarget = false;
+    m_overlap.fill(0);
+}
+
+int TimeStretch::write(const float *input, int frames)
+{
+    if (!m_channels)
+        return 0;
+
+    // Drop what no later block can reach.
+    const int drop = qMin(m_inputFrames, int(m_position) - m_radius);
+    if (drop > 0 && m_inputFrames + frames > m_capacity) {
+        const int kept = m_inputFrames - drop;
+        memmove(m_input.data(), m_input.constData() + drop * m_channels, size_t(kept * m_channels) * sizeof(float));
+        memmove(m_mono.data(), m_mono.constData() + drop, size_t(kept) * sizeof(float));
+        m_inputFrames = kept;
+        m_position -= drop;
+    }
+
+    const int count = qMin(frames, m_capacity - m_inputFrames);
+    memcpy(m_input.data() + m_inputFrames * m_channels, input, size_t(count * m_channels) * sizeof(float));
+
+    float *mono = m_mono.data() + m_inputFrames;
+    for (int i = 0; i < count; ++i) {
+        float sum = 0;
+        for (int c = 0; c < m_channels; ++c)
+            sum += input[i * m_channels + c];
+        mono[i] = sum;
+    }
+
+    m_inputFrames += count;
+    return count;
+}
+
+// Offset around base whose first half window correlates best with the
+// natural continuation of the previous segment.
+int TimeStretch::bestOffset(int base) const
+{
+    if (!m_hasTarget)
+        return 0;
+
+    const int first = qMax(-m_radius, -base);
+    int best = 0;
+    double bestScore = -1e30;
+
+    for (int offset = first; offset <= m_radius; offset += 2) {
+        const float *candidate = m_mono.constData() + base + offset;
+        double correlation = 0;
+        double energy = 1e-9;
+        for (int i = 0; i < m_hop; i += 2) {
+            correlation += double(candidate[i]) * m_target[i];
+            energy += double(candidate[i]) * candidate[i];
+        }
+
+        const double score = correlation / qSqrt(energy);
+        if (score > bestScore) {
+            bestScore = score;
+            best = offset;
+        }
+    }
+
+    return best;
+}
+
+bool TimeStretch::read(float *output)
+{
+    if (!m_channels)
+        return false;
+
+    const int base = int(m_position);
+    if (base + m_radius + m_window > m_inputFrames)
+        return false;
+
+    const int segment = base + bestOffset(base);
+    const float *in = m_input.constData() + segment * m_channels;
+    const float *tail = in + m_hop * m_channels;
+
+    for (int i = 0; i < m_hop; ++i) {
+        const float head = m_hann[i];
+        const float fade = m_hann[m_hop + i];
+        for (int c = 0; c < m_channels; ++c) {
+            const int k = i * m_channels + c;
+            output[k] = m_overlap[k] + head * in[k];
+            m_overlap[k] = fade * tail[k];
+        }
+    }
+
+    memcpy(m_target.data(), m_mono.constData() + segment + m_hop, size_t(m_hop) * sizeof(float));
+    m_hasTarget = true;
+    m_position += m_hop * m_rate;
+    return true;
+}
+
+template <typename T>
+static void toFloat(const T *data, int count, float offset, float scale, float *out)
+{
+    for (int i = 0; i < count; ++i)
+        out[i] = (float(data[i]) - offset) * scale;
+}
+
+// Converts the common little-endian pcm formats, returns false for the rest.
+static bool toFloat(const QAudioBuffer &buffer, float *out)
+{
+    const QAudioFormat format = buffer.format();
+    const int count = buffer.sampleCount();
+
+    if (format.byteOrder() != QAudioFormat::LittleEndian || format.codec() != "audio/pcm")
+        return false;
+
+    switch (format.sampleType()) {
+    case QAudioFormat::SignedInt:
+        if (format.sampleSize() == 16)
+            toFloat(buffer.constData<qint16>(), count, 0, 1.0f / 32768, out);
+        else if (format.sampleSize() == 32)
+            toFloat(buffer.constData<qint32>(), count, 0, 1.0f / 2147483648.0f, out);
+        else if (format.sampleSize() == 8)
+            toFloat(buffer.constData<qint8>(), count, 0, 1.0f / 128, out);
+        else
+            return false;
+        return true;
+    case QAudioFormat::UnSignedInt:
+        if (format.sampleSize() == 16)
+            toFloat(buffer.constData<quint16>(), count, 32768, 1.0f / 32768, out);
+        else if (format.sampleSize() == 8)
+            toFloat(buffer.constData<quint8>(), count, 128, 1.0f / 128, out);
+        else
+            return false;
+        return true;
+    case QAudioFormat::Float:
+        if (format.sampleSize() != 32)
+            return false;
+        memcpy(out, buffer.constData<float>(), size_t(count) * sizeof(float));
+        return true;
+    default:
+        return false;
+    }
+}
+
+TimeStretchOutput::TimeStretchOutput(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TimeStretchOutput::~TimeStretchOutput()
+{
+    closeOutput();
+}
+
+void TimeStretchOutput::setActive(bool active)
+{
+    if (active == m_active)
+        return;
+
+    m_active = active;
+    if (!active)
+        closeOutput();
+}
+
+void TimeStretchOutput::setRate(qreal rate)
+{
+    m_rate = rate;
+    m_stretch.setRate(rate);
+}
+
+void TimeStretchOutput::setVolume(int volume)
+{
+    m_volume = volume;
+    updateVolume();
+}
+
+void TimeStretchOutput::setMuted(bool muted)
+{
+    m_muted = muted;
+    updateVolume();
+}
+
+void TimeStretchOutput::updateVolume()
+{
+    if (m_output)
+        m_output->setVolume(m_muted ? 0 : m_volume / qreal(100));
+}
+
+void TimeStretchOutput::processBuffer(const QAudioBuffer &buffer)
+{
+    if (!m_active || !buffer.isValid())
+        return;
+
+    TRACE_SCOPE("TimeStretchOutput::processBuffer");
+    const QAudioFormat format = buffer.format();
+    if (format.sampleRate() != m_format.sampleRate() || format.channelCount() != m_format.channelCount()) {
+        closeOutput();
+        if (!openOutput(format))
+            return;
+    }
+    if (!m_output)
+        return;
+
+    // A jump in the stream is a seek: start over instead of blending across it.
+    if (m_nextTime >= 0 && qAbs(buffer.startTime() - m_nextTime) > 100000) {
+        m_stretch.reset();
+        clearQueue();
+    }
+    m_nextTime = buffer.startTime() + format.durationForFrames(buffer.frameCount());
+
+    if (m_samples.size() < buffer.sampleCount())
+        m_samples.resize(buffer.sampleCount());
+    if (!toFloat(buffer, m_samples.data()))
+        return;
+
+    const int channels = m_stretch.channels();
+    const int blockBytes = m_stretch.blockFrames() * channels * int(sizeof(qint16));
+    const float *input = m_samples.constData();
+    int frames = buffer.frameCount();
+
+    while (frames > 0) {
+        const int taken = m_stretch.write(input, frames);
+        input += taken * channels;
+        frames -= taken;
+
+        bool produced = false;
+        while (m_stretch.read(m_block.data())) {
+            produced = true;
+            qint16 *pcm = reinterpret_cast<qint16 *>(m_pcm.data());
+            for (int i = 0; i < m_block.size(); ++i)
+                pcm[i] = qint16(qBound(-32768, qRound(m_block[i] * 32767), 32767));
+            queueBlock(m_pcm.constData(), blockBytes);
+        }
+
+        if (!taken && !produced)
+            break;
+    }
+
+    drain();
+}
+
+void TimeStretchOutput::queueBlock(const char *data, int bytes)
+{
+    // Only a sustained overflow gets here; the FIFO holds several bursts.
+    if (m_queue.size() - m_queueFill < bytes)
+        return;
+
+    const int write = (m_queueRead + m_queueFill) % m_queue.size();
+    const int first = qMin(bytes, m_queue.size() - write);
+    memcpy(m_queue.data() + write, data, size_t(first));
+    memcpy(m_queue.data(), data + first, size_t(bytes - first));
+    m_queueFill += bytes;
+}
+
+void TimeStretchOutput::clearQueue()
+{
+    m_queueRead = 0;
+    m_queueFill = 0;
+}
+
+// Called for every probed buffer and on the output's notify ticks, which keep
+// the device fed while the probe is slow to deliver at low rates.
+void TimeStretchOutput::drain()
+{
+    if (!m_device)
+        return;
+
+    const int frameBytes = m_stretch.channels() * int(sizeof(qint16));
+    while (m_queueFill > 0) {
+        const int free = m_output->bytesFree() / frameBytes * frameBytes;
+        const int chunk = qMin(qMin(m_queueFill, m_queue.size() - m_queueRead), free);
+        if (chunk <= 0)
+            break;
+
+        const qint64 written = m_device->write(m_queue.constData() + m_queueRead, chunk);
+        if (written <= 0)
+            break;
+        m_queueRead = (m_queueRead + int(written)) % m_queue.size();
+        m_queueFill -= int(written);
+    }
+}
+
+bool TimeStretchOutput::openOutput(const QAudioFormat &format)
+{
+    QAudioFormat outputFormat;
+    outputFormat.setSampleRate(format.sampleRate());
+    outputFormat.setChannelCount(format.channelCount());
+    outputFormat.setSampleSize(16);
+    outputFormat.setSampleType(QAudioFormat::SignedInt);
+    outputFormat.setByteOrder(QAudioFormat::LittleEndian);
+    outputFormat.setCodec("audio/pcm");
+
+    m_format = format;
+    if (!QAudioDeviceInfo::defaultOutputDevice().isFormatSupported(outputFormat)) {
+        qWarning() << "Time stretch: unsupported output format" << outputFormat;
+        return false;
+    }
+
+    m_stretch.setFormat(format.sampleRate(), format.channelCount());
+    m_stretch.setRate(m_rate);
+    m_block.resize(m_stretch.blockFrames() * format.channelCount());
+    m_pcm.resize(m_block.size() * int(sizeof(qint16)));
+
+    // A second of audio: a 250 ms probe buffer at the slowest rate (0.25x)
+    // still fits, with the FIFO a whole number of blocks long so a block
+    // never wraps mid-frame.
+    const int blocksPerSecond = (format.sampleRate() + m_stretch.blockFrames() - 1) / m_stretch.blockFrames();
+    m_queue.resize(blocksPerSecond * m_pcm.size());
+    clearQueue();
+
+    m_output = new QAudioOutput(outputFormat, this);
+    // Eight blocks of slack in the device: enough to ride out probe jitter,
+    // short enough to stay close to the picture. The FIFO absorbs bursts.
+    m_output->setBufferSize(8 * m_pcm.size());
+    m_output->setNotifyInterval(10);
+    connect(m_output, &QAudioOutput::notify, this, &TimeStretchOutput::drain);
+    m_device = m_output->start();
+    updateVolume();
+    return true;
+}
+
+void TimeStretchOutput::closeOutput()
+{
+    if (m_output) {
+        m_output->stop();
+        delete m_output;
+    }
+    m_output = nullptr;
+    m_device = nullptr;
+    clearQueue();
+    m_format = QAudioFormat();
+    m_nextTime = -1;
+}
\ No newline at end of file
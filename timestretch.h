@@ -0,0 +1,104 @@
+#ifndef TIMESTRETCH_H
+#define TIMESTRETCH_H
+
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QObject>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QAudioOutput;
+class QIODevice;
+QT_END_NAMESPACE
+
+// Pitch preserving time-scale modification (WSOLA) of interleaved float audio.
+//
+// Output is produced in fixed blocks of half a window. Every block overlap-adds
+// the input segment around the nominal analysis position that best continues
+// the previous one; the search compares a downmix at every other sample and
+// offset, so a block costs the same whatever the rate. All buffers are
+// allocated by setFormat().
+class TimeStretch
+{
+public:
+    void setFormat(int sampleRate, int channels);
+    int channels() const { return m_channels; }
+    int blockFrames() const { return m_hop; }
+
+    qreal rate() const { return m_rate; }
+    void setRate(qreal rate);
+    void reset();
+
+    // Buffers up to frames of input and returns how many were taken.
+    int write(const float *input, int frames);
+    // Writes blockFrames() frames to output once enough input is buffered.
+    bool read(float *output);
+
+private:
+    int bestOffset(int base) const;
+
+    int m_channels = 0;
+    int m_window = 0;
+    int m_hop = 0;
+    int m_radius = 0;
+    int m_capacity = 0;
+    qreal m_rate = 1.0;
+
+    QVector<float> m_input;
+    QVector<float> m_mono;
+    QVector<float> m_overlap;
+    QVector<float> m_target;
+    QVector<float> m_hann;
+    int m_inputFrames = 0;
+    double m_position = 0;
+    bool m_hasTarget = false;
+};
+
+// Plays the probed audio of a muted player through its own output, time
+// stretched back to real time, for backends that change the pitch along
+// with the playback rate. Below 1x one probed buffer turns into a burst of
+// several blocks; they wait in a preallocated FIFO that is drained into the
+// device as it plays, and blocks are only dropped when the FIFO overflows.
+class TimeStretchOutput : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimeStretchOutput(QObject *parent = nullptr);
+    ~TimeStretchOutput();
+
+    bool isActive() const { return m_active; }
+    void setActive(bool active);
+
+public slots:
+    void setRate(qreal rate);
+    void setVolume(int volume);
+    void setMuted(bool muted);
+    void processBuffer(const QAudioBuffer &buffer);
+
+private:
+    bool openOutput(const QAudioFormat &format);
+    void closeOutput();
+    void updateVolume();
+    void queueBlock(const char *data, int bytes);
+    void clearQueue();
+    void drain();
+
+    TimeStretch m_stretch;
+    QAudioFormat m_format;
+    QAudioOutput *m_output = nullptr;
+    QIODevice *m_device = nullptr;
+    QVector<float> m_samples;
+    QVector<float> m_block;
+    QByteArray m_pcm;
+    QByteArray m_queue;
+    int m_queueRead = 0;
+    int m_queueFill = 0;
+    qint64 m_nextTime = -1;
+    qreal m_rate = 1.0;
+    int m_volume = 100;
+    bool m_muted = false;
+    bool m_active = false;
+};
+
+#endif // TIMESTRETCH_H
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "tracer.h"
+#include "perfcounters.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+namespace {
+
+const int RingSize = 1 << 16;
+
+struct Event
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+};
+
+// The owning thread is the only writer; the mutex is only ever contended
+// while a trace is being exported.
+struct ThreadBuffer
+{
+    QMutex mutex;
+    QVector<Event> events;
+    int next = 0;
+    int id = 0;
+    QString name;
+};
+
+QAtomicInt enabled;
+QMutex registryMutex;
+QList<ThreadBuffer *> registry;
+QString outputFileName;
+thread_local ThreadBuffer *localBuffer = nullptr;
+
+ThreadBuffer *threadBuffer()
+{
+    if (localBuffer)
+        return localBuffer;
+
+    // Kept for the lifetime of the process so events of finished threads
+    // still end up in the export.
+    ThreadBuffer *buffer = new ThreadBuffer;
+    buffer->events.reserve(RingSize);
+
+    QThread *thread = QThread::currentThread();
+    buffer->name = thread->objectName();
+    if (QCoreApplication::instance() && QCoreApplication::instance()->thread() == thread)
+        buffer->name = "main";
+
+    QMutexLocker locker(&registryMutex);
+    registry.append(buffer);
+    buffer->id = registry.size();
+    if (buffer->name.isEmpty())
+        buffer->name = QString("thread %1").arg(buffer->id);
+
+    localBuffer = buffer;
+    return buffer;
+}
+
+QByteArray jsonString(const QString &text)
+{
+    QByteArray escaped = text.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"");
+    return '"' + escaped + '"';
+}
+
+}
+
+bool Tracer::isEnabled()
+{
+    return enabled.load();
+}
+
+void Tracer::setEnabled(bool on)
+{
+    enabled.store(on ? 1 : 0);
+}
+
+QString Tracer::outputFile()
+{
+    QMutexLocker locker(&registryMutex);
+    return outputFileName;
+}
+
+void Tracer::setOutputFile(const QString &fileName)
+{
+    QMutexLocker locker(&registryMutex);
+    outputFileName = fileName;
+}
+
+void Tracer::addEvent(const char *name, qint64 start, qint64 duration)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+
+    Event event = { name, start, duration };
+    if (buffer->events.size() < RingSize)
+        buffer->events.append(event);
+    else
+        buffer->events[buffer->next] = event;
+    buffer->next = (buffer->next + 1) % RingSize;
+}
+
+bool Tracer::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    qint64 pid = QCoreApplication::applicationPid();
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    QMutexLocker registryLocker(&registryMutex);
+    for (ThreadBuffer *buffer : qAsConst(registry)) {
+        QMutexLocker locker(&buffer->mutex);
+
+        if (!first)
+            out += ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + QByteArray::number(pid)
+                + ",\"tid\":" + QByteArray::number(buffer->id)
+                + ",\"args\":{\"name\":" + jsonString(buffer->name) + "}}";
+
+        // Oldest first once the ring has wrapped.
+        int count = buffer->events.size();
+        int begin = count < RingSize ? 0 : buffer->next;
+        for (int i = 0; i < count; ++i) {
+            const Event &event = buffer->events.at((begin + i) % count);
+            out += ",\n{\"name\":\"" + QByteArray(event.name) + "\",\"ph\":\"X\",\"pid\":"
+                    + QByteArray::number(pid) + ",\"tid\":" + QByteArray::number(buffer->id)
+                    + ",\"ts\":" + QByteArray::number(event.start / 1000.0, 'f', 3)
+                    + ",\"dur\":" + QByteArray::number(event.duration / 1000.0, 'f', 3) + '}';
+        }
+
+        if (out.size() > (1 << 20)) {
+            file.write(out);
+            out.clear();
+        }
+    }
+
+    out += "\n]}\n";
+    return file.write(out) == out.size();
+}
+
+TraceScope::TraceScope(const char *name)
+    : m_name(Tracer::isEnabled() ? name : nullptr)
+{
+    if (m_name)
+        m_start = PerfCounters::now();
+}
+
+void TraceScope::end()
+{
+    if (!m_name)
+        return;
+
+    Tracer::addEvent(m_name, m_start, PerfCounters::now() - m_start);
+    m_name = nullptr;
+}
\ No newline at end of file
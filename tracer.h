@@ -0,0 +1,41 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+
+// Records scoped trace events of the playback pipeline and exports them in the
+// Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+//
+// Every thread appends to its own fixed size ring, so a long session keeps
+// its most recent events. Event names must be string literals.
+class Tracer
+{
+public:
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    static QString outputFile();
+    static void setOutputFile(const QString &fileName);
+
+    static void addEvent(const char *name, qint64 start, qint64 duration);
+    static bool writeChromeTrace(const QString &fileName);
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name);
+    ~TraceScope() { end(); }
+
+    void end();
+
+private:
+    const char *m_name;
+    qint64 m_start = 0;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif // TRACER_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "videoframesurface.h"
+
+VideoFrameSurface::VideoFrameSurface(QObject *parent)
+    : QAbstractVideoSurface(parent)
+{
+    // Formats QImage can wrap directly; the backend converts anything else.
+    m_formats << QVideoFrame::Format_RGB32
+              << QVideoFrame::Format_ARGB32
+              << QVideoFrame::Format_ARGB32_Premultiplied
+              << QVideoFrame::Format_RGB24;
+}
+
+QList<QVideoFrame::PixelFormat> VideoFrameSurface::supportedPixelFormats(
+        QAbstractVideoBuffer::HandleType type) const
+{
+    if (type != QAbstractVideoBuffer::NoHandle)
+        return QList<QVideoFrame::PixelFormat>();
+
+    return m_formats;
+}
+
+bool VideoFrameSurface::present(const QVideoFrame &frame)
+{
+    if (!frame.isValid())
+        return false;
+
+    emit frameAvailable(frame);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef VIDEOFRAMESURFACE_H
+#define VIDEOFRAMESURFACE_H
+
+#include <QAbstractVideoSurface>
+#include <QList>
+
+// A video output that renders nothing and hands every presented frame on.
+// Used wherever frames are needed without a visible QVideoWidget.
+class VideoFrameSurface : public QAbstractVideoSurface
+{
+    Q_OBJECT
+
+public:
+    explicit VideoFrameSurface(QObject *parent = nullptr);
+
+    void setPixelFormats(const QList<QVideoFrame::PixelFormat> &formats) { m_formats = formats; }
+
+    QList<QVideoFrame::PixelFormat> supportedPixelFormats(
+            QAbstractVideoBuffer::HandleType type = QAbstractVideoBuffer::NoHandle) const override;
+    bool present(const QVideoFrame &frame) override;
+
+signals:
+    void frameAvailable(const QVideoFrame &frame);
+
+private:
+    QList<QVideoFrame::PixelFormat> m_formats;
+};
+
+#endif // VIDEOFRAMESURFACE_H
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "videoframeview.h"
+
+// Byte offset of a byte of a 32 bit word given most significant first, as
+// in the 0xAARRGGBB notation the pixel formats are documented with.
+static int wordByte(int index)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    return 3 - index;
+#else
+    return index;
+#endif
+}
+
+VideoFrameView::VideoFrameView(QVideoFrame &frame)
+    : m_frame(frame)
+{
+    if (!frame.isMapped()) {
+        if (!frame.map(QAbstractVideoBuffer::ReadOnly))
+            return;
+        m_mapped = true;
+    }
+
+    m_pixelFormat = frame.pixelFormat();
+    m_width = frame.width();
+    m_height = frame.height();
+    m_valid = true;
+
+    switch (m_pixelFormat) {
+    case QVideoFrame::Format_YUV420P:
+        setupPlanar(0, 1, 2, 1, 1);
+        break;
+    case QVideoFrame::Format_YV12:
+        setupPlanar(0, 2, 1, 1, 1);
+        break;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+    case QVideoFrame::Format_YUV422P:
+        setupPlanar(0, 1, 2, 1, 0);
+        break;
+#endif
+    case QVideoFrame::Format_IMC1:
+        setupPlanar(0, 2, 1, 1, 1);
+        break;
+    case QVideoFrame::Format_IMC3:
+        setupPlanar(0, 1, 2, 1, 1);
+        break;
+    case QVideoFrame::Format_IMC2:
+    case QVideoFrame::Format_IMC4: {
+        // both chroma planes share lines, V on the left for IMC2
+        int half = frame.bytesPerLine(1) / 2;
+        bool vFirst = m_pixelFormat == QVideoFrame::Format_IMC2;
+        setupPacked(&m_y, 0, 0, 1);
+        setupPacked(&m_v, 1, vFirst ? 0 : half, 1, 1);
+        setupPacked(&m_u, 1, vFirst ? half : 0, 1, 1);
+        m_u.yShift = m_v.yShift = 1;
+        break;
+    }
+    case QVideoFrame::Format_NV12:
+    case QVideoFrame::Format_NV21: {
+        bool uFirst = m_pixelFormat == QVideoFrame::Format_NV12;
+        setupPacked(&m_y, 0, 0, 1);
+        setupPacked(&m_u, 1, uFirst ? 0 : 1, 2, 1);
+        setupPacked(&m_v, 1, uFirst ? 1 : 0, 2, 1);
+        m_u.yShift = m_v.yShift = 1;
+        break;
+    }
+    case QVideoFrame::Format_UYVY:
+        setupPacked(&m_u, 0, 0, 4, 1);
+        setupPacked(&m_y, 0, 1, 2);
+        setupPacked(&m_v, 0, 2, 4, 1);
+        break;
+    case QVideoFrame::Format_YUYV:
+        setupPacked(&m_y, 0, 0, 2);
+        setupPacked(&m_u, 0, 1, 4, 1);
+        setupPacked(&m_v, 0, 3, 4, 1);
+        break;
+    case QVideoFrame::Format_YUV444:
+        setupPacked(&m_y, 0, 0, 3);
+        setupPacked(&m_u, 0, 1, 3);
+        setupPacked(&m_v, 0, 2, 3);
+        break;
+    case QVideoFrame::Format_AYUV444:
+    case QVideoFrame::Format_AYUV444_Premultiplied:
+        setupPacked(&m_a, 0, wordByte(0), 4);
+        setupPacked(&m_y, 0, wordByte(1), 4);
+        setupPacked(&m_u, 0, wordByte(2), 4);
+        setupPacked(&m_v, 0, wordByte(3), 4);
+        break;
+    case QVideoFrame::Format_Y8:
+        setupPacked(&m_y, 0, 0, 1);
+        break;
+    case QVideoFrame::Format_Y16:
+        // Qt 5 has no P010/P016; 16 bit luma is the deepest format it exposes.
+        setupPacked(&m_y, 0, 0, 2);
+        m_y.bitDepth = 16;
+        m_y.significantBits = 16;
+        break;
+    case QVideoFrame::Format_ARGB32:
+    case QVideoFrame::Format_ARGB32_Premultiplied:
+    case QVideoFrame::Format_RGB32:
+        setupRgb32(1, 2, 3, 0);
+        break;
+    case QVideoFrame::Format_BGRA32:
+    case QVideoFrame::Format_BGRA32_Premultiplied:
+    case QVideoFrame::Format_BGR32:
+        setupRgb32(2, 1, 0, 3);
+        break;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+    case QVideoFrame::Format_ABGR32:
+        setupRgb32(3, 2, 1, 0);
+        break;
+#endif
+    case QVideoFrame::Format_RGB24:
+        setupPacked(&m_r, 0, 0, 3);
+        setupPacked(&m_g, 0, 1, 3);
+        setupPacked(&m_b, 0, 2, 3);
+        break;
+    case QVideoFrame::Format_BGR24:
+        setupPacked(&m_b, 0, 0, 3);
+        setupPacked(&m_g, 0, 1, 3);
+        setupPacked(&m_r, 0, 2, 3);
+        break;
+    default: {
+        // 16 bit packed RGB; QImage knows how to unpack the ones it supports
+        QImage::Format imageFormat = QVideoFrame::imageFormatFromPixelFormat(m_pixelFormat);
+        if (imageFormat != QImage::Format_Invalid)
+            m_image = QImage(frame.bits(), m_width, m_height, frame.bytesPerLine(), imageFormat);
+        else
+            m_valid = false;
+        break;
+    }
+    }
+
+    // RGB32 has no meaningful alpha byte
+    if (m_pixelFormat == QVideoFrame::Format_RGB32 || m_pixelFormat == QVideoFrame::Format_BGR32)
+        m_a = Component();
+}
+
+VideoFrameView::~VideoFrameView()
+{
+    release();
+}
+
+void VideoFrameView::release()
+{
+    if (m_mapped)
+        m_frame.unmap();
+    m_mapped = false;
+    m_valid = false;
+    m_y = m_u = m_v = Component();
+    m_r = m_g = m_b = m_a = Component();
+    m_image = QImage();
+}
+
+void VideoFrameView::setupPlanar(int yPlane, int uPlane, int vPlane, int xShift, int yShift)
+{
+    setupPacked(&m_y, yPlane, 0, 1);
+    setupPacked(&m_u, uPlane, 0, 1, xShift);
+    setupPacked(&m_v, vPlane, 0, 1, xShift);
+    m_u.yShift = m_v.yShift = yShift;
+}
+
+void VideoFrameView::setupPacked(Component *component, int plane, int offset, int step, int xShift)
+{
+    if (plane >= m_frame.planeCount())
+        return;
+
+    component->data = m_frame.bits(plane) + offset;
+    component->bytesPerLine = m_frame.bytesPerLine(plane);
+    component->step = step;
+    component->xShift = xShift;
+}
+
+void VideoFrameView::setupRgb32(int r, int g, int b, int a)
+{
+    setupPacked(&m_r, 0, wordByte(r), 4);
+    setupPacked(&m_g, 0, wordByte(g), 4);
+    setupPacked(&m_b, 0, wordByte(b), 4);
+    setupPacked(&m_a, 0, wordByte(a), 4);
+}
+
+QRgb VideoFrameView::pixel(int x, int y) const
+{
+    if (isRgb())
+        return qRgb(m_r.value(x, y), m_g.value(x, y), m_b.value(x, y));
+    if (!m_image.isNull())
+        return m_image.pixel(x, y);
+    return 0;
+}
+
+int VideoFrameView::luma(int x, int y) const
+{
+    if (isYuv())
+        return m_y.value8(x, y);
+    return qGray(pixel(x, y));
+}
+
+void VideoFrameView::chroma(int x, int y, int *u, int *v) const
+{
+    if (m_u.isValid() && m_v.isValid()) {
+        *u = m_u.value8(x, y);
+        *v = m_v.value8(x, y);
+        return;
+    }
+    if (isYuv()) {
+        *u = *v = 128;
+        return;
+    }
+
+    // BT.601
+    QRgb rgb = pixel(x, y);
+    int r = qRed(rgb);
+    int g = qGreen(rgb);
+    int b = qBlue(rgb);
+    *u = qBound(0, (-43 * r - 85 * g + 128 * b) / 256 + 128, 255);
+    *v = qBound(0, (128 * r - 107 * g - 21 * b) / 256 + 128, 255);
+}
\ No newline at end of file
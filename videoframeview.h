@@ -0,0 +1,102 @@
+#ifndef VIDEOFRAMEVIEW_H
+#define VIDEOFRAMEVIEW_H
+
+#include <QImage>
+#include <QVideoFrame>
+
+// Read-only access to the samples of a video frame without copying it.
+//
+// The frame is mapped for the lifetime of the view (unless it already was).
+// Every byte addressable component (Y, U, V, R, G, B, A) of planar,
+// semi-planar and packed formats is described by a Component, so kernels
+// can walk the mapped memory directly. Packed 16 bit RGB formats are read
+// through a QImage wrapping the mapped data; compressed and raw camera
+// formats are not supported.
+class VideoFrameView
+{
+public:
+    struct Component
+    {
+        const uchar *data = nullptr;
+        int bytesPerLine = 0;
+        int step = 0;       // bytes between horizontally adjacent samples
+        int xShift = 0;     // log2 of the horizontal subsampling
+        int yShift = 0;     // log2 of the vertical subsampling
+        int bitDepth = 8;   // storage: 8, or 16 for little-endian 16 bit words
+        int significantBits = 8;
+        bool msbAligned = false; // significant bits at the top of the word
+
+        bool isValid() const { return data; }
+
+        const uchar *line(int y) const { return data + (y >> yShift) * bytesPerLine; }
+
+        int value(int x, int y) const
+        {
+            const uchar *sample = line(y) + (x >> xShift) * step;
+            return bitDepth > 8 ? sample[0] | (sample[1] << 8) : sample[0];
+        }
+
+        // The sample scaled to 8 bits.
+        int value8(int x, int y) const
+        {
+            int sample = value(x, y);
+            if (bitDepth == 8)
+                return sample;
+            if (msbAligned)
+                return sample >> 8;
+            return (sample & ((1 << significantBits) - 1)) >> (significantBits - 8);
+        }
+    };
+
+    explicit VideoFrameView(QVideoFrame &frame);
+    ~VideoFrameView();
+
+    // Unmaps the frame before the view goes away; the view is invalid after.
+    void release();
+
+    bool isValid() const { return m_valid; }
+    QVideoFrame::PixelFormat pixelFormat() const { return m_pixelFormat; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    bool isYuv() const { return m_y.isValid(); }
+    bool isRgb() const { return m_r.isValid(); }
+
+    const Component &y() const { return m_y; }
+    const Component &u() const { return m_u; }
+    const Component &v() const { return m_v; }
+    const Component &r() const { return m_r; }
+    const Component &g() const { return m_g; }
+    const Component &b() const { return m_b; }
+    const Component &a() const { return m_a; }
+
+    // 8 bit luma and BT.601 chroma at a pixel, whatever the format.
+    int luma(int x, int y) const;
+    void chroma(int x, int y, int *u, int *v) const;
+
+private:
+    Q_DISABLE_COPY(VideoFrameView)
+
+    void setupPlanar(int yPlane, int uPlane, int vPlane, int xShift, int yShift);
+    void setupPacked(Component *component, int plane, int offset, int step, int xShift = 0);
+    void setupRgb32(int r, int g, int b, int a);
+    QRgb pixel(int x, int y) const;
+
+    QVideoFrame &m_frame;
+    bool m_mapped = false;
+    bool m_valid = false;
+    QVideoFrame::PixelFormat m_pixelFormat = QVideoFrame::Format_Invalid;
+    int m_width = 0;
+    int m_height = 0;
+
+    Component m_y;
+    Component m_u;
+    Component m_v;
+    Component m_r;
+    Component m_g;
+    Component m_b;
+    Component m_a;
+    QImage m_image;
+};
+
+#endif // VIDEOFRAMEVIEW_H
\ No newline at end of file
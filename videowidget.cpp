@@ -1,6 +1,7 @@
 #include "videowidget.h"
 
 #include <QKeyEvent>
+#include <QLabel>
 #include <QMouseEvent>
 
 VideoWidget::VideoWidget(QWidget *parent)
@@ -13,6 +14,47 @@ VideoWidget::VideoWidget(QWidget *parent)
     setPalette(p);
 
     setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_perfOverlay = new QLabel(this);
+    m_perfOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_perfOverlay->setStyleSheet("QLabel { background: rgba(0, 0, 0, 160); color: white;"
+                                 " font-family: monospace; padding: 4px; }");
+    m_perfOverlay->move(8, 8);
+    m_perfOverlay->hide();
+
+    m_perfTimer.setInterval(1000);
+    connect(&m_perfTimer, &QTimer::timeout, this, &VideoWidget::updatePerfOverlay);
+}
+
+bool VideoWidget::isPerfOverlayVisible() const
+{
+    return m_perfOverlay->isVisible();
+}
+
+void VideoWidget::setPerfOverlayVisible(bool visible)
+{
+    if (visible == isPerfOverlayVisible())
+        return;
+
+    if (visible) {
+        m_perfSnapshot = PerfCounters::snapshot();
+        m_perfOverlay->setText(tr("collecting..."));
+        m_perfOverlay->adjustSize();
+        m_perfOverlay->show();
+        m_perfOverlay->raise();
+        m_perfTimer.start();
+    } else {
+        m_perfTimer.stop();
+        m_perfOverlay->hide();
+    }
+}
+
+void VideoWidget::updatePerfOverlay()
+{
+    PerfCounters::Snapshot current = PerfCounters::snapshot();
+    m_perfOverlay->setText(PerfCounters::format(current, m_perfSnapshot));
+    m_perfOverlay->adjustSize();
+    m_perfSnapshot = current;
 }
 
 void VideoWidget::keyPressEvent(QKeyEvent *event)
@@ -23,6 +65,9 @@ void VideoWidget::keyPressEvent(QKeyEvent *event)
     } else if (event->key() == Qt::Key_Enter && event->modifiers() & Qt::Key_Alt) {
         setFullScreen(!isFullScreen());
         event->accept();
+    } else if (event->key() == Qt::Key_F12) {
+        setPerfOverlayVisible(!isPerfOverlayVisible());
+        event->accept();
     } else {
         QVideoWidget::keyPressEvent(event);
     }
@@ -37,4 +82,10 @@ void VideoWidget::mouseDoubleClickEvent(QMouseEvent *event)
 void VideoWidget::mousePressEvent(QMouseEvent *event)
 {
     QVideoWidget::mousePressEvent(event);
+}
+
+void VideoWidget::paintEvent(QPaintEvent *event)
+{
+    PerfTimer timer(PerfCounters::VideoPaint);
+    QVideoWidget::paintEvent(event);
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #ifndef VIDEOWIDGET_H
 #define VIDEOWIDGET_H
 
+#include "perfcounters.h"
+
+#include <QTimer>
 #include <QVideoWidget>
 
+QT_BEGIN_NAMESPACE
+class QLabel;
+QT_END_NAMESPACE
+
 class VideoWidget : public QVideoWidget
 {
     Q_OBJECT
@@ -10,10 +17,21 @@ class VideoWidget : public QVideoWidget
 public:
     explicit VideoWidget(QWidget *parent = nullptr);
 
+    bool isPerfOverlayVisible() const;
+    void setPerfOverlayVisible(bool visible);
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void updatePerfOverlay();
+
+    QLabel *m_perfOverlay = nullptr;
+    QTimer m_perfTimer;
+    PerfCounters::Snapshot m_perfSnapshot;
 };
 
 #endif // VIDEOWIDGET_H
\ No newline at end of file